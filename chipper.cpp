@@ -34,10 +34,18 @@ int WinMain(int argc, char *argv[]) {
 int main(int argc, char *argv[]) {
 #endif
     chipperSDL3* sdl;
+    chipperRELAY* relay;
     chippy::tehCHIP* b;
 
     std::string romFileName = "";
     chippy::systype compat = chippy::CHIP8; // we default to Chip-8 compat.
+    chippy::coretype core = chippy::INTERPRETER;
+    // Quirks forced on, or off, on top of the defaults for our compat mode.
+    unsigned int quirksOn = 0;
+    unsigned int quirksOff = 0;
+    // Instructions per frame, or 0 to keep the default.
+    int ipf = 0;
+    bool turbo = false;
  
     int choice = 0;
     // This loop iterates over every valid argument
@@ -49,11 +57,19 @@ int main(int argc, char *argv[]) {
             {"fullscreen",  no_argument,        0,  'f'},
             {"chip48",      no_argument,        0,  'p'},
             {"superchip",   no_argument,        0,  's'},
+            {"superchip11", no_argument,        0,  'S'},
+            {"xochip",      no_argument,        0,  'x'},
             {"rom",         required_argument,  0,  'r'},
+            {"translate",   no_argument,        0,  't'},
+            {"threaded",    no_argument,        0,  'T'},
+            {"ipf",         required_argument,  0,  'i'},
+            {"turbo",       no_argument,        0,  'u'},
+            {"quirk",       required_argument,  0,  'q'},
+            {"no-quirk",    required_argument,  0,  'Q'},
             {"help",        no_argument,        0,  'h'},
             {0,             0,                  0,  0}
         };
-        choice = getopt_long(argc, argv, "mfsr", long_options, &optionIndex);
+        choice = getopt_long(argc, argv, "mfsSxrtTi:uq:Q:", long_options, &optionIndex);
 
         // getopt returns -1  when there are no more options, break the loop.
         // Using less than 0 to cover the insane case of an overflow, because
@@ -83,9 +99,38 @@ int main(int argc, char *argv[]) {
             case 's':
                 compat = chippy::SUPERCHIP10;
                 break;
+            case 'S':
+                compat = chippy::SUPERCHIP11;
+                break;
+            case 'x':
+                compat = chippy::XOCHIP;
+                break;
             case 'p':
                 compat = chippy::CHIP48;
                 break;
+            case 't':
+                core = chippy::TRANSLATOR;
+                break;
+            case 'T':
+                core = chippy::THREADED;
+                break;
+            case 'i':
+                ipf = atoi(optarg);
+                if (ipf <= 0) {
+                    std::cout << "Invalid instructions per frame: " << optarg 
+                              << std::endl;
+                    ipf = 0;
+                } // else do_nothing();
+                break;
+            case 'u':
+                turbo = true;
+                break;
+            case 'q':
+                quirksOn |= chippy::tehCHIP::parse_quirk(optarg);
+                break;
+            case 'Q':
+                quirksOff |= chippy::tehCHIP::parse_quirk(optarg);
+                break;
             default:
                 // do_nothing();
                 break;
@@ -109,11 +154,71 @@ int main(int argc, char *argv[]) {
     } else {
         try {
             sdl = new chipperSDL3();
-            b = new chippy::tehCHIP(*sdl, *sdl, *sdl, compat);
+            relay = new chipperRELAY(*sdl, *sdl, *sdl);
+            unsigned int quirks = (DEFAULT_QUIRKS(compat) | quirksOn)
+                                & ~quirksOff;
+            b = new chippy::tehCHIP(*relay, *relay, *relay, compat, core, 
+                                    quirks);
+            if (ipf > 0) {
+                b->set_instructions_per_frame(ipf);
+            } // else do_nothing();
+            b->set_turbo(turbo);
             b->load_program(romFileName);
-            b->execute();
+
+            // The emulator runs on a thread of its own, and talks to SDL only
+            // through the relay. SDL wants its events, and its renderer, 
+            // handled on the main thread, so that's where we service the 
+            // relay, once every 60th of a second. A slow present only ever 
+            // holds this thread up.
+            std::atomic<bool> running(true);
+            std::exception_ptr failure;
+            std::thread emulation([&]() {
+                try {
+                    b->execute();
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+                running.store(false);
+            });
+            const std::chrono::steady_clock::duration frame 
+                = std::chrono::duration_cast<
+                    std::chrono::steady_clock::duration>(
+                        std::chrono::duration<long long, std::ratio<1, 60>>(1));
+            std::chrono::steady_clock::time_point deadline 
+                = std::chrono::steady_clock::now();
+            // If SDL throws, the emulator has to be stopped, and joined, 
+            // before the exception leaves this scope, or the still-joinable
+            // thread takes the whole program down with it.
+            try {
+                while (running.load()) {
+                    sdl->process_events();
+                    relay->forward_input();
+                    relay->present();
+                    deadline += frame;
+                    if (std::chrono::steady_clock::now() > deadline + frame) {
+                        deadline = std::chrono::steady_clock::now();
+                    } // else do_nothing();
+                    std::this_thread::sleep_until(deadline);
+                }
+            } catch (...) {
+                relay->request_exit();
+                emulation.join();
+                throw;
+            }
+            emulation.join();
+            if (failure) {
+                std::rethrow_exception(failure);
+            } // else do_nothing();
+
+            if (core == chippy::TRANSLATOR) {
+                b->report_fusion();
+            } // else do_nothing();
+            if (turbo) {
+                b->report_speed();
+            } // else do_nothing();
             std::cout << "Exiting program!" << std::endl;
             delete b;
+            delete relay;
             delete sdl;
         } catch (const std::out_of_range &e) {
             std::cout << "Out of range error: " << e.what() << std::endl;
@@ -2,8 +2,14 @@
 #include "tehCOMMONZ.h"
 // #include "chipperSDL.h"
 #include "chipperSDL3.h"
+#include "chipperRELAY.h"
 
 // #include <nfd.h>
 #include <iostream>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
 #include <getopt.h>
 #include <sys/stat.h>
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "chipperEXPAND.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && !defined(CHIPPY_NO_SIMD)
+#define CHIPPY_X86_SIMD
+#include <immintrin.h>
+#endif
+
+typedef void (*bit_expander)(const uint64_t*, uint32_t*, int, uint32_t,
+                             uint32_t);
+typedef void (*pair_expander)(const uint64_t*, const uint64_t*, uint32_t*, int,
+                              const uint32_t*);
+
+// The bit of pixel i, counting from the most significant bit of the first word.
+static inline int bit_at(const uint64_t* data, int i) {
+    return (int) ((data[i >> 6] >> (63 - (i & 63))) & 0x1);
+}
+
+// The byte holding pixels i to i + 7, where i is a multiple of 8.
+static inline unsigned int byte_at(const uint64_t* data, int i) {
+    return (unsigned int) ((data[i >> 6] >> (56 - (i & 63))) & 0xFF);
+}
+
+/**
+ * Starting at first, rather than at zero, lets the vector loops hand over
+ *   whatever is left of a row that isn't a whole number of bytes.
+ */
+
+static void bits_scalar(const uint64_t* data, uint32_t* pixels, int first,
+                        int count, uint32_t foreground, uint32_t background) {
+    for (int i = first; i < count; i++) {
+        pixels[i] = bit_at(data, i) ? foreground : background;
+    }
+    return;
+}
+
+static void pair_scalar(const uint64_t* low, const uint64_t* high,
+                        uint32_t* pixels, int first, int count,
+                        const uint32_t* colors) {
+    for (int i = first; i < count; i++) {
+        pixels[i] = colors[bit_at(low, i) | (bit_at(high, i) << 1)];
+    }
+    return;
+}
+
+static void expand_bits_scalar(const uint64_t* data, uint32_t* pixels,
+                               int count, uint32_t foreground,
+                               uint32_t background) {
+    bits_scalar(data, pixels, 0, count, foreground, background);
+    return;
+}
+
+static void expand_pair_scalar(const uint64_t* low, const uint64_t* high,
+                               uint32_t* pixels, int count,
+                               const uint32_t* colors) {
+    pair_scalar(low, high, pixels, 0, count, colors);
+    return;
+}
+
+#ifdef CHIPPY_X86_SIMD
+
+/**
+ * Eight pixels come from each byte of a word. Broadcasting the byte into every
+ *   lane, and masking off a different bit in each, gives a lane that's equal to
+ *   its mask only where the pixel is lit. That comparison is our select mask.
+ *   SSE2 only has four lanes, so each byte is done in two halves.
+ */
+
+__attribute__((target("sse2")))
+static inline __m128i select_sse2(__m128i mask, __m128i set, __m128i clear) {
+    return _mm_or_si128(_mm_and_si128(mask, set),
+                        _mm_andnot_si128(mask, clear));
+}
+
+__attribute__((target("sse2")))
+static void expand_bits_sse2(const uint64_t* data, uint32_t* pixels, int count,
+                             uint32_t foreground, uint32_t background) {
+    const __m128i left = _mm_setr_epi32(0x80, 0x40, 0x20, 0x10);
+    const __m128i right = _mm_setr_epi32(0x08, 0x04, 0x02, 0x01);
+    const __m128i fg = _mm_set1_epi32((int) foreground);
+    const __m128i bg = _mm_set1_epi32((int) background);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i byte = _mm_set1_epi32((int) byte_at(data, i));
+        __m128i lit_left = _mm_cmpeq_epi32(_mm_and_si128(byte, left), left);
+        __m128i lit_right = _mm_cmpeq_epi32(_mm_and_si128(byte, right), right);
+        _mm_storeu_si128((__m128i*) (pixels + i),
+                         select_sse2(lit_left, fg, bg));
+        _mm_storeu_si128((__m128i*) (pixels + i + 4),
+                         select_sse2(lit_right, fg, bg));
+    }
+    bits_scalar(data, pixels, i, count, foreground, background);
+    return;
+}
+
+__attribute__((target("sse2")))
+static void expand_pair_sse2(const uint64_t* low, const uint64_t* high,
+                             uint32_t* pixels, int count,
+                             const uint32_t* colors) {
+    const __m128i halves[2] = {
+        _mm_setr_epi32(0x80, 0x40, 0x20, 0x10),
+        _mm_setr_epi32(0x08, 0x04, 0x02, 0x01)
+    };
+    const __m128i c0 = _mm_set1_epi32((int) colors[0]);
+    const __m128i c1 = _mm_set1_epi32((int) colors[1]);
+    const __m128i c2 = _mm_set1_epi32((int) colors[2]);
+    const __m128i c3 = _mm_set1_epi32((int) colors[3]);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i bytes[2] = {
+            _mm_set1_epi32((int) byte_at(low, i)),
+            _mm_set1_epi32((int) byte_at(high, i))
+        };
+        for (int h = 0; h < 2; h++) {
+            __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(bytes[0], halves[h]),
+                                         halves[h]);
+            __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(bytes[1], halves[h]),
+                                         halves[h]);
+            __m128i color = select_sse2(m1, select_sse2(m0, c3, c2),
+                                        select_sse2(m0, c1, c0));
+            _mm_storeu_si128((__m128i*) (pixels + i + (h * 4)), color);
+        }
+    }
+    pair_scalar(low, high, pixels, i, count, colors);
+    return;
+}
+
+/**
+ * AVX2 has eight lanes, so a whole byte goes at once, and can blend on the mask.
+ */
+
+__attribute__((target("avx2")))
+static void expand_bits_avx2(const uint64_t* data, uint32_t* pixels, int count,
+                             uint32_t foreground, uint32_t background) {
+    const __m256i lanes
+        = _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m256i fg = _mm256_set1_epi32((int) foreground);
+    const __m256i bg = _mm256_set1_epi32((int) background);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i byte = _mm256_set1_epi32((int) byte_at(data, i));
+        __m256i lit = _mm256_cmpeq_epi32(_mm256_and_si256(byte, lanes), lanes);
+        _mm256_storeu_si256((__m256i*) (pixels + i),
+                            _mm256_blendv_epi8(bg, fg, lit));
+    }
+    bits_scalar(data, pixels, i, count, foreground, background);
+    return;
+}
+
+__attribute__((target("avx2")))
+static void expand_pair_avx2(const uint64_t* low, const uint64_t* high,
+                             uint32_t* pixels, int count,
+                             const uint32_t* colors) {
+    const __m256i lanes
+        = _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m256i c0 = _mm256_set1_epi32((int) colors[0]);
+    const __m256i c1 = _mm256_set1_epi32((int) colors[1]);
+    const __m256i c2 = _mm256_set1_epi32((int) colors[2]);
+    const __m256i c3 = _mm256_set1_epi32((int) colors[3]);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i b0 = _mm256_set1_epi32((int) byte_at(low, i));
+        __m256i b1 = _mm256_set1_epi32((int) byte_at(high, i));
+        __m256i m0 = _mm256_cmpeq_epi32(_mm256_and_si256(b0, lanes), lanes);
+        __m256i m1 = _mm256_cmpeq_epi32(_mm256_and_si256(b1, lanes), lanes);
+        __m256i color = _mm256_blendv_epi8(_mm256_blendv_epi8(c0, c1, m0),
+                                           _mm256_blendv_epi8(c2, c3, m0), m1);
+        _mm256_storeu_si256((__m256i*) (pixels + i), color);
+    }
+    pair_scalar(low, high, pixels, i, count, colors);
+    return;
+}
+
+#endif
+
+static bit_expander pick_bit_expander() {
+    bit_expander result = expand_bits_scalar;
+#ifdef CHIPPY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        result = expand_bits_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        result = expand_bits_sse2;
+    } // else, stick with the scalar loop.
+#endif
+    return result;
+}
+
+static pair_expander pick_pair_expander() {
+    pair_expander result = expand_pair_scalar;
+#ifdef CHIPPY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        result = expand_pair_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        result = expand_pair_sse2;
+    } // else, stick with the scalar loop.
+#endif
+    return result;
+}
+
+void expand_bits(const uint64_t* data, uint32_t* pixels, int count,
+                 uint32_t foreground, uint32_t background) {
+    static const bit_expander expand = pick_bit_expander();
+    expand(data, pixels, count, foreground, background);
+    return;
+}
+
+void expand_planes(const uint64_t* const* planes, int plane_count,
+                   uint32_t* pixels, int count, const uint32_t* colors) {
+    static const pair_expander expand_pair = pick_pair_expander();
+    if (plane_count == 1) {
+        expand_bits(planes[0], pixels, count, colors[1], colors[0]);
+    } else if (plane_count == 2) {
+        expand_pair(planes[0], planes[1], pixels, count, colors);
+    } else {
+        for (int i = 0; i < count; i++) {
+            int index = 0;
+            for (int p = 0; p < plane_count; p++) {
+                index |= bit_at(planes[p], i) << p;
+            }
+            pixels[i] = colors[index];
+        }
+    }
+    return;
+}
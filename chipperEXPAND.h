@@ -0,0 +1,50 @@
+/**
+ * @file chipperEXPAND.h
+ * @author William Tradewell
+ * @brief Expands packed framebuffer data into RGBA8888 pixels.
+ * @version 0.2
+ * @date 2026-10-17
+ */
+
+#ifndef CHIPPEREXPAND_H_
+#define CHIPPEREXPAND_H_
+
+#include <cstdint>
+
+/**
+ * @brief Expands one bit per pixel into one RGBA8888 color per pixel.
+ *
+ * Data is read as packed 64 bit words, with the leftmost pixel in the most
+ *  significant bit. Every set bit becomes the foreground color, and every clear
+ *  bit becomes the background color. On x86 processors, this is done 8 pixels
+ *  at a time using AVX2, or SSE2, whichever is the best the processor supports.
+ *  This is checked once, on the first call. Everywhere else, or if
+ *  CHIPPY_NO_SIMD is defined, it's done one pixel at a time.
+ *
+ * @param data Pointer to the packed screen data to expand.
+ * @param pixels Pointer to at least count pixels to expand into.
+ * @param count The number of pixels to expand.
+ * @param foreground The RGBA8888 color of a lit pixel.
+ * @param background The RGBA8888 color of an unlit pixel.
+ */
+void expand_bits(const uint64_t* data, uint32_t* pixels, int count,
+                 uint32_t foreground, uint32_t background);
+
+/**
+ * @brief Composes several planes of packed bits into RGBA8888 pixels.
+ *
+ * Every pixel's bit from each plane makes up an index into colors, with the
+ *  first plane in bit 0. All planes are read in the same pass. One plane is
+ *  handed to expand_bits(), and two planes are composed 8 pixels at a time,
+ *  just like it.
+ *
+ * @param planes Pointers to the packed data for each plane.
+ * @param plane_count The number of planes.
+ * @param pixels Pointer to at least count pixels to expand into.
+ * @param count The number of pixels to expand.
+ * @param colors The RGBA8888 color for each index, 1 << plane_count of them.
+ */
+void expand_planes(const uint64_t* const* planes, int plane_count,
+                   uint32_t* pixels, int count, const uint32_t* colors);
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file chipperHEADLESS.cpp
+ * @author William Tradewell
+ * @brief Runs the interpreter without a window, a speaker, or a keyboard.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * This is built as chippy8-headless, which never touches SDL3, for machines
+ *  that have no display or audio device. A ROM is run, as fast as it can be,
+ *  for a set number of frames or instructions. Afterwards, the registers, a
+ *  hash of the framebuffer, and how long it all took are printed, so that runs
+ *  can be compared against one another.
+ */
+
+#include "tehCHIP.h"
+#include "tehCOMMONZ.h"
+#include "chipperNULL.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+void print_help() {
+    std::cout <<
+"Chippy-8 headless, by: William Tradewell." << std::endl <<
+"Program usage: ./chippy8-headless <args> [rom file]" << std::endl <<
+"  -n, --frames <n>      Stop after n frames." << std::endl <<
+"  -c, --cycles <n>      Stop after n instructions." << std::endl <<
+"  -i, --ipf <n>         Run n instructions per frame." << std::endl <<
+"  -p, --chip48          CHIP-48 compatibility." << std::endl <<
+"  -s, --superchip       SUPERCHIP 1.0 compatibility." << std::endl <<
+"  -S, --superchip11     SUPERCHIP 1.1 compatibility." << std::endl <<
+"  -x, --xochip          XO-CHIP compatibility." << std::endl <<
+"  -t, --translate       Run translated blocks." << std::endl <<
+"  -T, --threaded        Run threaded code." << std::endl <<
+"  -k, --idle-skip       Fast-forward through idle loops." << std::endl <<
+"  -q, --quirk <name>    Force a quirk on." << std::endl <<
+"  -Q, --no-quirk <name> Force a quirk off." << std::endl <<
+"With neither limit, we stop after 600 frames." << std::endl;
+    return;
+}
+
+int main(int argc, char *argv[]) {
+    chipperNULL* null;
+    chippy::tehCHIP* b;
+
+    std::string romFileName = "";
+    chippy::systype compat = chippy::CHIP8; // we default to Chip-8 compat.
+    chippy::coretype core = chippy::INTERPRETER;
+    // Quirks forced on, or off, on top of the defaults for our compat mode.
+    unsigned int quirksOn = 0;
+    unsigned int quirksOff = 0;
+    // Instructions per frame, or 0 to keep the default.
+    int ipf = 0;
+    bool idleSkip = false;
+    unsigned long int frames = 0;
+    unsigned long long int cycles = 0;
+
+    int choice = 0;
+    // This loop iterates over every valid argument
+    while (true) {
+        int optionIndex = 0;
+        static struct option long_options[] = {
+            {"frames",      required_argument,  0,  'n'},
+            {"cycles",      required_argument,  0,  'c'},
+            {"ipf",         required_argument,  0,  'i'},
+            {"chip48",      no_argument,        0,  'p'},
+            {"superchip",   no_argument,        0,  's'},
+            {"superchip11", no_argument,        0,  'S'},
+            {"xochip",      no_argument,        0,  'x'},
+            {"translate",   no_argument,        0,  't'},
+            {"threaded",    no_argument,        0,  'T'},
+            {"idle-skip",   no_argument,        0,  'k'},
+            {"quirk",       required_argument,  0,  'q'},
+            {"no-quirk",    required_argument,  0,  'Q'},
+            {"help",        no_argument,        0,  'h'},
+            {0,             0,                  0,  0}
+        };
+        choice = getopt_long(argc, argv, "n:c:i:psSxtTkq:Q:h", long_options,
+                             &optionIndex);
+
+        // getopt returns -1 when there are no more options, break the loop.
+        if (choice < 0) {
+            break;
+        }
+
+        switch (choice) {
+            case 'h':
+                print_help();
+                break;
+            case 'n':
+                frames = strtoul(optarg, NULL, 10);
+                break;
+            case 'c':
+                cycles = strtoull(optarg, NULL, 10);
+                break;
+            case 'i':
+                ipf = atoi(optarg);
+                if (ipf <= 0) {
+                    std::cout << "Invalid instructions per frame: " << optarg
+                              << std::endl;
+                    ipf = 0;
+                } // else do_nothing();
+                break;
+            case 's':
+                compat = chippy::SUPERCHIP10;
+                break;
+            case 'S':
+                compat = chippy::SUPERCHIP11;
+                break;
+            case 'x':
+                compat = chippy::XOCHIP;
+                break;
+            case 'p':
+                compat = chippy::CHIP48;
+                break;
+            case 't':
+                core = chippy::TRANSLATOR;
+                break;
+            case 'T':
+                core = chippy::THREADED;
+                break;
+            case 'k':
+                idleSkip = true;
+                break;
+            case 'q':
+                quirksOn |= chippy::tehCHIP::parse_quirk(optarg);
+                break;
+            case 'Q':
+                quirksOff |= chippy::tehCHIP::parse_quirk(optarg);
+                break;
+            default:
+                // do_nothing();
+                break;
+        }
+    }
+
+    if (optind < argc) {
+        romFileName = argv[optind];
+    } // else do_nothing();
+
+    if ((frames == 0) && (cycles == 0)) {
+        frames = 600;
+    } // else do_nothing();
+
+    if (romFileName == "") {
+        std::cout << "Rom file not specified!\n";
+    } else {
+        try {
+            null = new chipperNULL();
+            unsigned int quirks = (DEFAULT_QUIRKS(compat) | quirksOn)
+                                & ~quirksOff;
+            b = new chippy::tehCHIP(*null, *null, *null, compat, core, quirks);
+            if (ipf > 0) {
+                b->set_instructions_per_frame(ipf);
+            } // else do_nothing();
+            b->set_idle_skip(idleSkip);
+            b->set_turbo(true);
+            b->set_limits(frames, cycles);
+            b->load_program(romFileName);
+            b->execute();
+            b->report_state();
+            b->report_speed();
+            if (core == chippy::TRANSLATOR) {
+                b->report_fusion();
+            } // else do_nothing();
+            delete b;
+            delete null;
+        } catch (const std::out_of_range &e) {
+            std::cout << "Out of range error: " << e.what() << std::endl;
+        } catch (const std::exception &e) {
+            std::cout << "Exception: " << e.what() << std::endl;
+        } catch (const char* &e) {
+            std::cout << "Exception: " << e << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -1,6 +1,21 @@
 #include "chipperNULL.h"
 
-void chipperNULL::copy_screen(bool* data, int size) {
+void chipperNULL::copy_screen(const uint64_t* /* data */, int /* size */) {
+	return;
+}
+
+void chipperNULL::copy_rows(const uint64_t* /* data */, int /* first */,
+                            int /* count */) {
+	return;
+}
+
+void chipperNULL::copy_planes(const uint64_t* const* /* planes */,
+                              int /* plane_count */, int /* first */,
+                              int /* count */) {
+	return;
+}
+
+void chipperNULL::set_planes(int /* count */) {
 	return;
 }
 
@@ -8,7 +23,7 @@ void chipperNULL::refresh_screen() {
 	return;
 }
 
-void chipperNULL::set_resolution(int w, int h) {
+void chipperNULL::set_resolution(int /* w */, int /* h */) {
 	return;
 }
 
@@ -20,7 +35,7 @@ int chipperNULL::get_height() {
 	return 32;
 }
 
-void chipperNULL::copy_audio(uint8_t* data, int size) {
+void chipperNULL::attach_tone(tehTONE* /* tone */) {
 	return;
 }
 
@@ -32,10 +47,6 @@ int chipperNULL::get_bytes_per_sample() {
 	return 2;
 }
 
-int chipperNULL::get_buffer_size() {
-	return 0; 
-}
-
 void chipperNULL::process_events() {
 	return;
 }
@@ -44,7 +55,7 @@ bool chipperNULL::get_exit_state() const {
 	return false;
 }
 
-bool chipperNULL::is_key_pressed(unsigned char value) const {
+bool chipperNULL::is_key_pressed(unsigned char /* value */) const {
 	return false;
 }
 
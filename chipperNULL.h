@@ -9,16 +9,19 @@
 
 class chipperNULL: public tehSCREEN, public tehBOOP, public tehBEEP {
 public:
-	void copy_screen(bool* data, int size);
+	void copy_screen(const uint64_t* data, int size);
+	void copy_rows(const uint64_t* data, int first, int count);
+	void copy_planes(const uint64_t* const* planes, int plane_count,
+	                 int first, int count);
+	void set_planes(int count);
 	void refresh_screen();
 	void set_resolution(int w, int h);
 	int get_width();
 	int get_height();
 
-	void copy_audio(uint8_t* data, int size);
+	void attach_tone(tehTONE* tone);
 	int get_sample_rate();
 	int get_bytes_per_sample();
-	int get_buffer_size();
 
 	void process_events();
 	bool get_exit_state() const;
@@ -0,0 +1,263 @@
+#include "chipperRELAY.h"
+
+chipperRELAY::chipperRELAY(tehSCREEN& s, tehBEEP& b, tehBOOP& k)
+                           : screen(s)
+                           , speaker(b)
+                           , keyboard(k)
+                           , exit(false) {
+    this->sample_rate = this->speaker.get_sample_rate();
+    this->bytes_per_sample = this->speaker.get_bytes_per_sample();
+    std::memset(&this->shadow, 0, sizeof(frame));
+    std::memset(&this->shown, 0, sizeof(frame));
+    this->shadow.width = 64;
+    this->shadow.height = 32;
+    this->shadow.planes = 1;
+    this->keys = 0;
+    this->has_waiting = false;
+    this->sent_keys = 0;
+    this->has_unsent = false;
+    return;
+}
+
+// Display side
+
+/**
+ * A change that couldn't be queued, because the ring was full, is held onto,
+ *   and nothing after it is sent until it has been, so that the order is kept.
+ *   Keys that are sent by state alone are left out of sent_keys if they can't
+ *   be queued, so that they're tried again next time.
+ */
+void chipperRELAY::forward_input() {
+    bool sending = true;
+    while (sending) {
+        if (!this->has_unsent) {
+            this->has_unsent = this->keyboard.next_key_change(
+                this->unsent.key, this->unsent.pressed);
+        } // else, do_nothing();
+        if (this->has_unsent && this->key_events.push(&this->unsent, 1) == 1) {
+            if (this->unsent.pressed) {
+                this->sent_keys |= 1 << this->unsent.key;
+            } else {
+                this->sent_keys &= ~(1 << this->unsent.key);
+            }
+            this->has_unsent = false;
+        } else {
+            sending = false;
+        }
+    }
+
+    if (!this->has_unsent) {
+        int held = 0;
+        for (int i = 0; i < 0x10; i++) {
+            if (this->keyboard.is_key_pressed(i)) {
+                held |= 1 << i;
+            } // else, do_nothing();
+        }
+        int changed = held ^ this->sent_keys;
+        for (int i = 0; i < 0x10; i++) {
+            if ((changed >> i) & 0x1) {
+                key_event e = { (unsigned char) i, ((held >> i) & 0x1) != 0 };
+                if (this->key_events.push(&e, 1) == 1) {
+                    this->sent_keys ^= 1 << i;
+                } // else, do_nothing();
+            } // else, do_nothing();
+        }
+    } // else, do_nothing();
+    if (this->keyboard.get_exit_state()) {
+        this->exit.store(true, std::memory_order_release);
+    } // else, do_nothing();
+    return;
+}
+
+void chipperRELAY::request_exit() {
+    this->exit.store(true, std::memory_order_release);
+    return;
+}
+
+/**
+ * Changing the resolution, or the number of planes, throws away everything
+ *   the screen held, so every row is sent after either. The plane count goes
+ *   first, just as tehVIDEO sends it, so the screen is built to suit.
+ */
+void chipperRELAY::present() {
+    if (this->frames.update()) {
+        const frame& f = this->frames.get_front();
+        bool everything = false;
+        if (f.planes != this->shown.planes) {
+            this->screen.set_planes(f.planes);
+            everything = true;
+        } // else, do_nothing();
+        if (f.width != this->shown.width || f.height != this->shown.height) {
+            this->screen.set_resolution(f.width, f.height);
+            everything = true;
+        } // else, do_nothing();
+
+        int words = f.width / 64;
+        int y = 0;
+        while (y < f.height) {
+            int first = y;
+            while (y < f.height && (everything
+                || std::memcmp(&f.rows[0][y * words],
+                               &this->shown.rows[0][y * words], words * 8) != 0
+                || (f.planes > 1
+                 && std::memcmp(&f.rows[1][y * words],
+                                &this->shown.rows[1][y * words],
+                                words * 8) != 0))) {
+                y++;
+            }
+            if (y > first) {
+                this->send_rows(f, first, y - first);
+            } else {
+                y++;
+            }
+        }
+        this->shown = f;
+    } // else, do_nothing();
+    this->screen.refresh_screen();
+    return;
+}
+
+void chipperRELAY::send_rows(const frame& f, int first, int count) {
+    if (f.planes == 1) {
+        this->screen.copy_rows(f.rows[0], first, count);
+    } else {
+        const uint64_t* planes[chippy::MAX_PLANES];
+        for (int p = 0; p < chippy::MAX_PLANES; p++) {
+            planes[p] = f.rows[p];
+        }
+        this->screen.copy_planes(planes, f.planes, first, count);
+    }
+    return;
+}
+
+// Emulation side, implemented from tehSCREEN
+
+void chipperRELAY::copy_screen(const uint64_t* data, int size) {
+    this->copy_rows(data, 0, size / (this->shadow.width / 64));
+    return;
+}
+
+void chipperRELAY::copy_rows(const uint64_t* data, int first, int count) {
+    int words = this->shadow.width / 64;
+    std::memcpy(&this->shadow.rows[0][first * words], &data[first * words],
+                count * words * sizeof(uint64_t));
+    return;
+}
+
+void chipperRELAY::copy_planes(const uint64_t* const* planes, int plane_count,
+                               int first, int count) {
+    for (int p = 0; p < plane_count && p < chippy::MAX_PLANES; p++) {
+        int words = this->shadow.width / 64;
+        std::memcpy(&this->shadow.rows[p][first * words],
+                    &planes[p][first * words],
+                    count * words * sizeof(uint64_t));
+    }
+    return;
+}
+
+void chipperRELAY::set_planes(int count) {
+    if (count > 0 && count <= chippy::MAX_PLANES) {
+        this->shadow.planes = count;
+    } // else, do_nothing();
+    return;
+}
+
+/**
+ * The back buffer was last published at least two frames ago, so the whole
+ *   shadow is copied into it, not just the rows that changed.
+ */
+void chipperRELAY::refresh_screen() {
+    this->frames.get_back() = this->shadow;
+    this->frames.publish();
+    return;
+}
+
+void chipperRELAY::set_resolution(int w, int h) {
+    if (w > 0 && w <= MAX_WIDTH && h > 0 && h <= MAX_HEIGHT) {
+        this->shadow.width = w;
+        this->shadow.height = h;
+        std::memset(this->shadow.rows, 0, sizeof(this->shadow.rows));
+    } // else, do_nothing();
+    return;
+}
+
+int chipperRELAY::get_width() {
+    return this->shadow.width;
+}
+
+int chipperRELAY::get_height() {
+    return this->shadow.height;
+}
+
+// Emulation side, implemented from tehBOOP
+
+/**
+ * If a key has already changed this frame, its next change waits for the next
+ *   frame, along with everything queued after it. Otherwise a tap that arrived
+ *   whole between two frames would press, and release, before anything could
+ *   see it.
+ */
+void chipperRELAY::process_events() {
+    int changed = 0;
+    bool taking = true;
+    while (taking) {
+        if (!this->has_waiting) {
+            this->has_waiting = (this->key_events.pop(&this->waiting, 1) == 1);
+        } // else, do_nothing();
+        if (this->has_waiting && !((changed >> this->waiting.key) & 0x1)) {
+            if (this->waiting.pressed) {
+                this->keys |= 1 << this->waiting.key;
+            } else {
+                this->keys &= ~(1 << this->waiting.key);
+            }
+            changed |= 1 << this->waiting.key;
+            this->has_waiting = false;
+        } else {
+            taking = false;
+        }
+    }
+    return;
+}
+
+bool chipperRELAY::get_exit_state() const {
+    return this->exit.load(std::memory_order_acquire);
+}
+
+bool chipperRELAY::is_key_pressed(unsigned char value) const {
+    return ((this->keys >> (value & 0xF)) & 0x1) != 0;
+}
+
+/**
+ * Like chipperSDL3, this returns the lowest numbered key that's held, or 0x10
+ *   if there isn't one.
+ */
+unsigned char chipperRELAY::get_key_pressed() const {
+    unsigned char key_pressed = 0x10;
+    for (int i = 0; i < 0x10; i++) {
+        if ((this->keys >> i) & 0x1) {
+            key_pressed = i;
+            i = 0x10;
+        } // else, do_nothing();
+    }
+    return key_pressed;
+}
+
+// Emulation side, implemented from tehBEEP
+
+/**
+ * The tone is attached straight to the real speaker. It's attached, and 
+ *   detached, as the emulator is built, and torn down, which happens on the
+ *   thread that owns the speaker anyway.
+ */
+void chipperRELAY::attach_tone(tehTONE* t) {
+    this->speaker.attach_tone(t);
+    return;
+}
+
+int chipperRELAY::get_sample_rate() {
+    return this->sample_rate;
+}
+
+int chipperRELAY::get_bytes_per_sample() {
+    return this->bytes_per_sample;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file chipperRELAY.h
+ * @author William Tradewell
+ * @brief Carries video, input, and audio between the emulation thread, and
+ *  the thread that owns the real interfaces.
+ * @version 0.1
+ * @date 2026-10-17
+ */
+
+#ifndef CHIPPERRELAY_H_
+#define CHIPPERRELAY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "chipperRING.h"
+#include "chipperTRIPLE.h"
+#include "tehCOMMONZ.h"
+#include "tehSCREEN.h"
+#include "tehBOOP.h"
+#include "tehBEEP.h"
+
+/**
+ * @brief chipperRELAY lets the emulator run on a thread of its own.
+ *
+ * The emulator is given the relay in place of the real tehSCREEN, tehBEEP, and
+ *  tehBOOP, and never calls the real ones itself. Instead:
+ *
+ * - Finished frames are published through a triple buffer, so the emulator
+ *   never waits on a present, and the display always gets the newest frame.
+ * - Key presses, and releases, come the other way through a ring buffer. They
+ *   are taken from the real keyboard's next_key_change() where it has one,
+ *   so a tap that's over between two refreshes is still seen. The emulator
+ *   takes at most one change per key each time it processes events, so a
+ *   press, and its release, are never seen in the same frame.
+ * - Audio needs nothing from us. The speaker pulls it straight from the
+ *   emulator's tehTONE, which is safe to call from any thread.
+ *
+ * None of these ever take a lock. The thread that owns the real interfaces,
+ *  which for SDL has to be the main thread, should call forward_input(), and
+ *  present(), once per display refresh. Everything else is for the emulation
+ *  thread.
+ */
+class chipperRELAY: public tehSCREEN, public tehBEEP, public tehBOOP {
+private:
+    // The largest screen we can carry, SUPERCHIP's hi-res mode.
+    static const int MAX_WIDTH = 128;
+    static const int MAX_HEIGHT = 64;
+    static const int MAX_WORDS = MAX_WIDTH / 64;
+
+    // One whole screen, packed exactly as tehVIDEO packs vram.
+    struct frame {
+        uint64_t rows[chippy::MAX_PLANES][MAX_HEIGHT * MAX_WORDS];
+        int width;
+        int height;
+        int planes;
+    };
+
+    struct key_event {
+        unsigned char key;
+        bool pressed;
+    };
+
+    tehSCREEN& screen;
+    tehBEEP& speaker;
+    tehBOOP& keyboard;
+
+    // Shared between both threads.
+    chipperTRIPLE<frame> frames;
+    chipperRING<key_event, 64> key_events;
+    std::atomic<bool> exit;
+    // These never change, so they're read once, up front.
+    int sample_rate;
+    int bytes_per_sample;
+
+    // Emulation side. Every row, as tehVIDEO last sent it.
+    frame shadow;
+    // Emulation side. One bit per key, set while it's held.
+    int keys;
+    // Emulation side. A change taken from the ring, held for the next frame.
+    key_event waiting;
+    bool has_waiting;
+
+    // Display side. Every row, as the real screen last got it.
+    frame shown;
+    // Display side. One bit per key, as last sent to the emulation side.
+    int sent_keys;
+    // Display side. A change taken from the keyboard, while the ring was full.
+    key_event unsent;
+    bool has_unsent;
+
+    // Sends rows of the front frame to the real screen.
+    void send_rows(const frame& f, int first, int count);
+
+public:
+    /**
+     * @brief Wraps the real interfaces.
+     *
+     * @param s The real screen.
+     * @param b The real speaker.
+     * @param k The real keyboard.
+     */
+    chipperRELAY(tehSCREEN& s, tehBEEP& b, tehBOOP& k);
+
+    /**
+     * @brief Passes key changes, and the exit signal, to the emulation side.
+     *
+     * Call this right after the real keyboard has processed its events. Every
+     *  change the keyboard reports is sent, in order. After that, any key whose
+     *  state still differs from what was sent is sent as well.
+     */
+    void forward_input();
+
+    /**
+     * @brief Tells the emulation side to exit, whatever the keyboard says.
+     *
+     * Safe to call from either thread.
+     */
+    void request_exit();
+
+    /**
+     * @brief Shows the newest published frame on the real screen.
+     *
+     * Only rows that differ from what the screen already holds are copied.
+     *  The screen is refreshed even if there's no new frame, so that it can
+     *  repaint after the window is resized.
+     */
+    void present();
+
+    // Implemented from tehSCREEN
+    void copy_screen(const uint64_t* data, int size);
+    void copy_rows(const uint64_t* data, int first, int count);
+    void copy_planes(const uint64_t* const* planes, int plane_count,
+                     int first, int count);
+    void set_planes(int count);
+    void refresh_screen();
+    void set_resolution(int w, int h);
+    int get_width();
+    int get_height();
+
+    // Implemented from tehBOOP
+    void process_events();
+    bool get_exit_state() const;
+    bool is_key_pressed(unsigned char value) const;
+    unsigned char get_key_pressed() const;
+
+    // Implemented from tehBEEP
+    void attach_tone(tehTONE* t);
+    int get_sample_rate();
+    int get_bytes_per_sample();
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file chipperRING.h
+ * @author William Tradewell
+ * @brief A lock-free ring buffer, for handing data from one thread to another.
+ * @version 0.1
+ * @date 2026-10-17
+ */
+
+#ifndef CHIPPERRING_H_
+#define CHIPPERRING_H_
+
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @brief A fixed size, single producer, single consumer queue.
+ *
+ * Exactly one thread may push, and exactly one other thread may pop, without
+ *  either of them ever taking a lock, or waiting on the other. When the ring is
+ *  full, pushes are cut short, and when it's empty, pops come back with less
+ *  than was asked for.
+ *
+ * The head and tail only ever count up, wrapping around naturally, and are
+ *  masked down to an index when used. Their difference is always how much is
+ *  in the ring, so it can be filled right up, without a wasted slot.
+ *
+ * @tparam T The type of item to hold. It should be cheap to copy.
+ * @tparam N The number of items the ring can hold. Must be a power of two.
+ */
+template<class T, unsigned int N>
+class chipperRING {
+private:
+    T data[N];
+    // Where the next item is pushed. Only the producer writes this.
+    std::atomic<unsigned int> head;
+    // Where the next item is popped from. Only the consumer writes this.
+    std::atomic<unsigned int> tail;
+
+public:
+    chipperRING() : head(0), tail(0) {}
+
+    /**
+     * @brief Pushes as many items as there's room for. Producer only.
+     *
+     * @param items The items to push.
+     * @param count The number of items to push.
+     * @return The number of items actually pushed.
+     */
+    unsigned int push(const T* items, unsigned int count);
+
+    /**
+     * @brief Pops as many items as are available. Consumer only.
+     *
+     * @param items Where to copy the items to.
+     * @param count The most items to pop.
+     * @return The number of items actually popped.
+     */
+    unsigned int pop(T* items, unsigned int count);
+
+    /**
+     * @brief Returns how many items are waiting to be popped.
+     *
+     * This is only a snapshot. From the producer it may be too high, and from
+     *  the consumer it may be too low, but never the other way around.
+     *
+     * @return The number of items in the ring.
+     */
+    unsigned int size() const;
+};
+
+/**
+ * The items are copied before the head moves, and the release store makes sure
+ *   the consumer sees them once it sees the new head. A push that wraps past
+ *   the end of data is copied in two pieces.
+ */
+template<class T, unsigned int N>
+unsigned int chipperRING<T, N>::push(const T* items, unsigned int count) {
+    unsigned int h = this->head.load(std::memory_order_relaxed);
+    unsigned int t = this->tail.load(std::memory_order_acquire);
+    unsigned int room = N - (h - t);
+    count = (count < room) ? count : room;
+    unsigned int first = N - (h & (N - 1));
+    first = (count < first) ? count : first;
+    std::copy(items, items + first, &this->data[h & (N - 1)]);
+    std::copy(items + first, items + count, &this->data[0]);
+    this->head.store(h + count, std::memory_order_release);
+    return count;
+}
+
+template<class T, unsigned int N>
+unsigned int chipperRING<T, N>::pop(T* items, unsigned int count) {
+    unsigned int t = this->tail.load(std::memory_order_relaxed);
+    unsigned int h = this->head.load(std::memory_order_acquire);
+    unsigned int available = h - t;
+    count = (count < available) ? count : available;
+    unsigned int first = N - (t & (N - 1));
+    first = (count < first) ? count : first;
+    std::copy(&this->data[t & (N - 1)], &this->data[t & (N - 1)] + first,
+              items);
+    std::copy(&this->data[0], &this->data[0] + (count - first), items + first);
+    this->tail.store(t + count, std::memory_order_release);
+    return count;
+}
+
+template<class T, unsigned int N>
+unsigned int chipperRING<T, N>::size() const {
+    return this->head.load(std::memory_order_acquire)
+         - this->tail.load(std::memory_order_acquire);
+}
+
+#endif
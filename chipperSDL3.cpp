@@ -31,16 +31,45 @@ bool chipperSDL3::init_SDL_Audio() {
     // Once SDL's opened the audio device, it replaces these values with
     // what it is actually using.
     const SDL_AudioSpec spec = { SDL_AUDIO_S16, 2 ,this->samplesPerSecond };
+    // SDL calls fill_audio() for more samples whenever the stream runs low, so
+    // nothing is ever queued up ahead of time.
     this->audioStream = SDL_OpenAudioDeviceStream(
         SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK
         , &spec
-        , NULL
-        , NULL
+        , chipperSDL3::fill_audio
+        , this
     );
-    // TODO: verify this is working as you'd expect.
+    if (this->audioStream == NULL) {
+        result = false;
+    } // else do_nothing();
     return result;
 }
 
+/**
+ * SDL holds the stream's lock while it calls this, which is what makes it safe
+ *   for attach_tone() to swap tones out from under it. We fill in chunks, so
+ *   that the buffer can live on the stack.
+ */
+void SDLCALL chipperSDL3::fill_audio(void *userdata, SDL_AudioStream *stream,
+                                     int additional_amount, int total_amount) {
+    chipperSDL3* self = (chipperSDL3*) userdata;
+    int16_t chunk[1024];
+    int chunk_samples = (int) (sizeof(chunk) / self->bytesPerSample);
+    int samples = additional_amount / self->bytesPerSample;
+    (void) total_amount;
+    while (samples > 0) {
+        int count = (samples < chunk_samples) ? samples : chunk_samples;
+        if (self->tone != NULL) {
+            self->tone->generate_samples(chunk, count);
+        } else {
+            std::memset(chunk, 0, count * self->bytesPerSample);
+        }
+        SDL_PutAudioStreamData(stream, chunk, count * self->bytesPerSample);
+        samples -= count;
+    }
+    return;
+}
+
 bool chipperSDL3::init_SDL_window() {
     this->window_width = chippy::DEFAULT_WINDOW_WIDTH;
     this->window_height = chippy::DEFAULT_WINDOW_HEIGHT;
@@ -83,70 +112,232 @@ bool chipperSDL3::init_renderer() {
     return result;
 }
 
+/**
+ * @brief Create render_texture, in the smallest format the renderer handles.
+ * 
+ * Our screen is monochrome, so there's no sense in uploading 32 bits for every
+ *   pixel when one will do. We try a 1 bit per pixel indexed texture first, 
+ *   then an 8 bit per pixel one, each with a four color palette, and only fall
+ *   back to RGBA8888 if the renderer can't handle either. One bit can't hold
+ *   two planes, so XO-CHIP starts at 8 bits. Texture palettes were added in
+ *   SDL 3.4, so older versions always get RGBA8888.
+ */
 bool chipperSDL3::init_textures() {
     bool result = true;
+    bool created = false;
+
+#if SDL_VERSION_ATLEAST(3, 4, 0)
+    const SDL_Color colors[4] = {
+        this->background, this->foreground, this->foreground2, this->overlap
+    };
+    this->palette = SDL_CreatePalette(4);
+    if (this->palette != NULL 
+        && SDL_SetPaletteColors(this->palette, colors, 0, 4)) {
+        if (this->plane_count == 1
+            && this->renderer_supports(SDL_PIXELFORMAT_INDEX1MSB)) {
+            created = this->create_render_texture(SDL_PIXELFORMAT_INDEX1MSB);
+        } // else, do_nothing();
+        if (!created && this->renderer_supports(SDL_PIXELFORMAT_INDEX8)) {
+            created = this->create_render_texture(SDL_PIXELFORMAT_INDEX8);
+        } // else, do_nothing();
+    } // else, do_nothing();
+#else
+    this->palette = NULL;
+#endif
 
-    this->render_texture = SDL_CreateTexture(
-        this->renderer
-        , SDL_PIXELFORMAT_RGBA8888
-        , SDL_TEXTUREACCESS_STREAMING
-        , this->vbuf_w
-        , this->vbuf_h
-    );
+    if (!created) {
+        created = this->create_render_texture(SDL_PIXELFORMAT_RGBA8888);
+    } // else, do_nothing();
 
-    SDL_SetTextureBlendMode(this->render_texture, SDL_BLENDMODE_BLEND);
+    // If we still have no texture, something is wrong. Throw an error and set
+    // result to false.
+    if (!created) {
+        throw SDL_GetError();
+        result = false;
+    } else {
+        SDL_SetTextureBlendMode(this->render_texture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(this->render_texture, SDL_SCALEMODE_NEAREST);
+    }
 
-    this->fade_texture = SDL_CreateTexture(
+    return result;
+}
+
+bool chipperSDL3::renderer_supports(SDL_PixelFormat format) {
+    bool result = false;
+    const SDL_PixelFormat *formats = (const SDL_PixelFormat*) 
+        SDL_GetPointerProperty(
+            SDL_GetRendererProperties(this->renderer)
+            , SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER
+            , NULL
+        );
+    if (formats != NULL) {
+        for (int i = 0; formats[i] != SDL_PIXELFORMAT_UNKNOWN; i++) {
+            if (formats[i] == format) {
+                result = true;
+            } // else, do_nothing();
+        }
+    } // else, do_nothing();
+    return result;
+}
+
+bool chipperSDL3::create_render_texture(SDL_PixelFormat format) {
+    bool result = true;
+    this->render_texture = SDL_CreateTexture(
         this->renderer
-        , SDL_PIXELFORMAT_RGBA8888
-        , SDL_TEXTUREACCESS_TARGET
+        , format
+        , SDL_TEXTUREACCESS_STREAMING
         , this->vbuf_w
         , this->vbuf_h
     );
 
-    // If either texture is null, something is wrong. Throw an error and set
-    // result to false.
-    if (this->render_texture == NULL || this->fade_texture == NULL) {
-        throw SDL_GetError();
+    if (this->render_texture == NULL) {
         result = false;
-    } else {
-        SDL_SetTextureScaleMode(this->render_texture, SDL_SCALEMODE_NEAREST);
-        SDL_SetTextureScaleMode(this->fade_texture, SDL_SCALEMODE_NEAREST);
-    }
+    } else if (format != SDL_PIXELFORMAT_RGBA8888) {
+#if SDL_VERSION_ATLEAST(3, 4, 0)
+        if (!SDL_SetTexturePalette(this->render_texture, this->palette)) {
+            SDL_DestroyTexture(this->render_texture);
+            this->render_texture = NULL;
+            result = false;
+        } // else, do_nothing();
+#endif
+    } // else, do_nothing();
 
+    if (result) {
+        this->texture_format = format;
+    } // else, do_nothing();
     return result;
 }
 
 void chipperSDL3::delete_textures() {
     SDL_DestroyTexture(this->render_texture);
-    SDL_DestroyTexture(this->fade_texture);
     this->render_texture = NULL;
-    this->fade_texture = NULL;
+    if (this->palette != NULL) {
+        SDL_DestroyPalette(this->palette);
+        this->palette = NULL;
+    } // else, do_nothing();
     return;
 }
 
-void chipperSDL3::init_pixel_array() {
-    int array_size = sizeof(uint32_t) * this->vbuf_h * this->vbuf_w;
-    this->pixel_array = (uint32_t*) SDL_malloc(array_size);
+/**
+ * @brief Write a run of packed rows directly into the streaming texture.
+ * 
+ * SDL_LockTexture hands back write-only memory for the locked rect, with 
+ *   undefined contents, so every pixel in it must be written- Which is fine, as
+ *   we only ever lock exactly the rows being copied. Each row is written at
+ *   its own pitch, as the driver is free to pad them.
+ * 
+ * INDEX1MSB already stores the leftmost pixel in the most significant bit, so
+ *   each word just goes out a byte at a time, most significant byte first. 
+ *   Other formats have to be widened.
+ * 
+ * @param data Packed framebuffer, vbuf_w / 64 words per row.
+ * @param first First row to copy.
+ * @param count Number of rows to copy.
+ */
+void chipperSDL3::stream_rows(const uint64_t* data, int first, int count) {
+    const SDL_Rect lockrect = {0, first, this->vbuf_w, count};
+    const int words = this->vbuf_w / 64;
+    void *texels;
+    int pitch;
+    if (SDL_LockTexture(this->render_texture, &lockrect, &texels, &pitch)) {
+        for (int row = 0; row < count; row++) {
+            const uint64_t *src = data + ((first + row) * words);
+            uint8_t *dst = (uint8_t*) texels + (row * pitch);
+            switch (this->texture_format) {
+            case SDL_PIXELFORMAT_INDEX1MSB:
+                for (int w = 0; w < words; w++) {
+                    for (int i = 0; i < 8; i++) {
+                        dst[(w * 8) + i] = (uint8_t) (src[w] >> (56 - (i * 8)));
+                    }
+                }
+                break;
+            case SDL_PIXELFORMAT_INDEX8:
+                for (int x = 0; x < this->vbuf_w; x++) {
+                    dst[x] = (src[x / 64] >> (63 - (x % 64))) & 0x1;
+                }
+                break;
+            default:
+                expand_bits(src, (uint32_t*) dst, this->vbuf_w
+                    , this->palette_pixels[1], this->palette_pixels[0]);
+                break;
+            }
+        }
+        SDL_UnlockTexture(this->render_texture);
+    } // else, do_nothing();
     return;
 }
 
-void chipperSDL3::delete_pixel_array() {
-    SDL_free(this->pixel_array);
-    this->pixel_array = NULL;
+/**
+ * @brief Compose a run of rows from every plane into the streaming texture.
+ * 
+ * Each pixel's palette index is its bit from the first plane, plus twice its 
+ *   bit from the second, gathered from both planes in the same pass that
+ *   writes it out.
+ * 
+ * @param planes Packed planes, vbuf_w / 64 words per row.
+ * @param first First row to copy.
+ * @param count Number of rows to copy.
+ */
+void chipperSDL3::stream_planes(const uint64_t* const* planes, int first, 
+                                int count) {
+    const SDL_Rect lockrect = {0, first, this->vbuf_w, count};
+    const int words = this->vbuf_w / 64;
+    void *texels;
+    int pitch;
+    if (SDL_LockTexture(this->render_texture, &lockrect, &texels, &pitch)) {
+        for (int row = 0; row < count; row++) {
+            const uint64_t *src[2] = {
+                planes[0] + ((first + row) * words),
+                planes[1] + ((first + row) * words)
+            };
+            uint8_t *dst = (uint8_t*) texels + (row * pitch);
+            if (this->texture_format == SDL_PIXELFORMAT_INDEX8) {
+                for (int x = 0; x < this->vbuf_w; x++) {
+                    int bit = 63 - (x % 64);
+                    dst[x] = ((src[0][x / 64] >> bit) & 0x1)
+                           | (((src[1][x / 64] >> bit) & 0x1) << 1);
+                }
+            } else {
+                expand_planes(src, 2, (uint32_t*) dst, this->vbuf_w
+                    , this->palette_pixels);
+            }
+        }
+        SDL_UnlockTexture(this->render_texture);
+    } // else, do_nothing();
     return;
 }
 
 chipperSDL3::chipperSDL3() {
     this->SDL_Status = true; // Assume SDL is good- Set to false if init fails
+    this->audioStream = NULL;
+    this->tone = NULL;
     this->background.r = 0;
     this->background.g = 0;
     this->background.b = 0;
     this->foreground.r = 255;
     this->foreground.g = 255;
     this->foreground.b = 255;
+    this->background.a = 255;
+    this->foreground.a = 255;
+    this->foreground2.r = 170;
+    this->foreground2.g = 170;
+    this->foreground2.b = 170;
+    this->foreground2.a = 255;
+    this->overlap.r = 85;
+    this->overlap.g = 85;
+    this->overlap.b = 85;
+    this->overlap.a = 255;
+    const SDL_Color colors[4] = {
+        this->background, this->foreground, this->foreground2, this->overlap
+    };
+    for (int i = 0; i < 4; i++) {
+        this->palette_pixels[i] = (colors[i].r << 24) | (colors[i].g << 16)
+                                | (colors[i].b << 8) | 0xFF;
+    }
 
     // Sane defaults, but expect these to be overidden later on
+    this->palette = NULL;
+    this->plane_count = 1;
     this->vbuf_w = 64;
     this->vbuf_h = 32;
 
@@ -170,9 +361,6 @@ chipperSDL3::chipperSDL3() {
             , 255
         );
 
-        // Allocate pixel array
-        this->init_pixel_array();
-
         //Present the renderer
         SDL_RenderPresent(this->renderer);
 
@@ -188,15 +376,14 @@ chipperSDL3::chipperSDL3() {
 }
 
 chipperSDL3::~chipperSDL3() {
-    // Clean up SDL Audio
-    SDL_CloseAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK);
+    // Clean up SDL Audio. Destroying the stream closes its device, too, and
+    // stops any more calls to fill_audio().
+    SDL_DestroyAudioStream(this->audioStream);
+    this->audioStream = NULL;
     // Clean up SDL Rendering/Textures
+    this->delete_textures();
     SDL_DestroyRenderer(this->renderer);
-    SDL_DestroyTexture(this->render_texture);
-    SDL_DestroyTexture(this->fade_texture);
-    this->delete_pixel_array();
     this->renderer = NULL;
-    this->render_texture = NULL;
     // Clean up Window
     SDL_DestroyWindow(this->window);
     this->window = NULL;
@@ -205,11 +392,32 @@ chipperSDL3::~chipperSDL3() {
     return;
 }
 
-void chipperSDL3::copy_screen(bool* data, int size) {
-    // Build uint32_t array
-    for (auto i = 0; i < size; i++) {
-        this->pixel_array[i] = data[i] ? 0xFFFFFFFF : 0x000000FF;
-    }
+void chipperSDL3::copy_screen(const uint64_t* data, int size) {
+    this->stream_rows(data, 0, size / (this->vbuf_w / 64));
+    return;
+}
+
+void chipperSDL3::copy_rows(const uint64_t* data, int first, int count) {
+    this->stream_rows(data, first, count);
+    return;
+}
+
+void chipperSDL3::copy_planes(const uint64_t* const* planes, int plane_count,
+                              int first, int count) {
+    if (plane_count == 1) {
+        this->stream_rows(planes[0], first, count);
+    } else if (plane_count == 2 && this->plane_count == 2) {
+        this->stream_planes(planes, first, count);
+    } // else, do_nothing();
+    return;
+}
+
+void chipperSDL3::set_planes(int count) {
+    if (count > 0 && count <= 2 && count != this->plane_count) {
+        this->plane_count = count;
+        this->delete_textures();
+        this->init_textures();
+    } // else, do_nothing();
     return;
 }
 
@@ -220,22 +428,14 @@ void chipperSDL3::refresh_screen() {
     this->texrect.y = 0;
     this->texrect.w = this->vbuf_w;
     this->texrect.h = this->vbuf_h;
-    // Update texture with updated values
-    // Normally you would want to stream the texture, but I found that there's
-    // quite a lot more overhead with textures this small, than simply updating
-    // it.   
-    // TODO: Method to grab data from vram
-    SDL_UpdateTexture(this->render_texture, NULL, this->pixel_array, 4 * this->vbuf_w);
+    // The texture already holds the latest rows, streamed in by copy_rows, so
+    // all that's left is a single pass to the window.
     
     // Create rects for blit
     const SDL_FRect dstrect = {0, 0 , this->window_width, this->window_height};
-    // Copy render_texture to fade_texture 
-    SDL_SetRenderTarget(this->renderer, this->fade_texture);
-    SDL_RenderTexture(this->renderer, this->render_texture, &this->texrect, &this->texrect);
 
     // Copy texture to the renderer and present
-    SDL_SetRenderTarget(this->renderer, NULL);
-    SDL_RenderTexture(this->renderer, this->fade_texture, &this->texrect, &dstrect);
+    SDL_RenderTexture(this->renderer, this->render_texture, &this->texrect, &dstrect);
     SDL_RenderPresent(this->renderer);
     return;
 }
@@ -244,9 +444,7 @@ void chipperSDL3::set_resolution(int w, int h) {
     this->vbuf_w = w;
     this->vbuf_h = h;
     this->delete_textures();
-    this->delete_pixel_array();
     this->init_textures();
-    this->init_pixel_array();
     return;
 }
 
@@ -303,6 +501,21 @@ void chipperSDL3::process_events() {
             // The window has been restored from a minimized state.
             this->is_minimized = false;
             break;
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            // Held keys repeat, but the key only went down once.
+            if (!input.key.repeat) {
+                for (int i = 0; i < 0x10; i++) {
+                    if (this->map[i].external_code == input.key.scancode) {
+                        key_change change = { (unsigned char) i, 
+                                              input.key.down };
+                        // If nobody is taking these, the oldest are kept, and
+                        //   the state array still has the latest.
+                        this->key_changes.push(&change, 1);
+                    } // else, do_nothing();
+                }
+            } // else, do_nothing();
+            break;
         default:
             // do_nothing();
             break;
@@ -352,10 +565,26 @@ unsigned char chipperSDL3::get_key_pressed() const {
     return key_pressed;
 }
 
+bool chipperSDL3::next_key_change(unsigned char& key, bool& pressed) {
+    key_change change;
+    bool result = (this->key_changes.pop(&change, 1) == 1);
+    if (result) {
+        key = change.key;
+        pressed = change.pressed;
+    } // else, do_nothing();
+    return result;
+}
+
 // Implemented from tehBEEP
 
-void chipperSDL3::copy_audio(uint8_t* data, int size) {
-    SDL_PutAudioStreamData(this->audioStream, data, (Uint32)size);
+void chipperSDL3::attach_tone(tehTONE* t) {
+    if (this->audioStream != NULL) {
+        SDL_LockAudioStream(this->audioStream);
+        this->tone = t;
+        SDL_UnlockAudioStream(this->audioStream);
+    } else {
+        this->tone = t;
+    }
     return;
 }
 
@@ -367,6 +596,3 @@ int chipperSDL3::get_bytes_per_sample() {
     return this->bytesPerSample;
 }
 
-int chipperSDL3::get_buffer_size() {
-    return SDL_GetAudioStreamQueued(this->audioStream);
-}
@@ -9,6 +9,10 @@
 #ifndef CHIPPERSDL3_H_
 #define CHIPPERSDL3_H_
 
+#include <cstring>
+
+#include "chipperEXPAND.h"
+#include "chipperRING.h"
 #include "tehSCREEN.h"
 #include "tehBOOP.h"
 #include "tehBEEP.h"
@@ -42,14 +46,28 @@ private:
         SDL_SCANCODE_4, SDL_SCANCODE_R, SDL_SCANCODE_F, SDL_SCANCODE_V
     };
 
+    // A key press, or release, on one of the keys in map.
+    struct key_change {
+        unsigned char key;
+        bool pressed;
+    };
+    // Every change SDL has told us about, that hasn't been taken yet.
+    chipperRING<key_change, 64> key_changes;
+
     bool SDL_Status; // Hold copy of SDL Status code.
 
     // Variables used for framebuffer
-    uint32_t *pixel_array; // Array of pixels used to build display texture.
-    SDL_Texture *render_texture; // Pointer to the render texture.
-    SDL_Texture *fade_texture;
+    SDL_Texture *render_texture; // Streaming texture the screen expands into.
+    SDL_PixelFormat texture_format; // Format render_texture was created with.
+    SDL_Palette *palette; // Every color below, in order, for indexed formats.
     SDL_Renderer *renderer; // Pointer to the renderer.
-    SDL_Color background, foreground; // TODO: use these to replace hardcoded values
+    SDL_Color background, foreground;
+    // XO-CHIP's second plane, and where both of its planes overlap.
+    SDL_Color foreground2, overlap;
+    // The same colors, packed as RGBA8888 pixels, indexed by plane bits.
+    uint32_t palette_pixels[4];
+    // Number of planes the screen is made of.
+    int plane_count;
     SDL_FRect texrect;
     int vbuf_h, vbuf_w;
 
@@ -83,6 +101,8 @@ private:
     // A struct holding all of the various audio configuration variables.
     SDL_AudioSpec audioSettings;
     SDL_AudioStream *audioStream;
+    // Where audioStream pulls samples from. Only changed with the stream locked.
+    tehTONE *tone;
  
     // Keeps track of what audio device we're using.
     int deviceID;
@@ -94,21 +114,32 @@ private:
     // Private initialization functions.
     bool init_SDL();
     bool init_SDL_Audio();
+    // Called from SDL's audio thread whenever audioStream runs low.
+    static void SDLCALL fill_audio(void *userdata, SDL_AudioStream *stream,
+                                   int additional_amount, int total_amount);
     bool init_SDL_window();
     bool init_renderer();
     bool init_textures();
-    void init_pixel_array();
+    bool renderer_supports(SDL_PixelFormat format);
+    bool create_render_texture(SDL_PixelFormat format);
 
     // Helper functions to clean up allocated memory.
     void delete_textures();
-    void delete_pixel_array();
+
+    // Lock rows of render_texture, and write pixels straight into them.
+    void stream_rows(const uint64_t* data, int first, int count);
+    void stream_planes(const uint64_t* const* planes, int first, int count);
 
 public:
     chipperSDL3();
     ~chipperSDL3();
 
     // Implemented from tehSCREEN
-    void copy_screen(bool* data, int size);
+    void copy_screen(const uint64_t* data, int size);
+    void copy_rows(const uint64_t* data, int first, int count);
+    void copy_planes(const uint64_t* const* planes, int plane_count, 
+                     int first, int count);
+    void set_planes(int count);
     void refresh_screen();
     void set_resolution(int w, int h);
     int get_width();
@@ -119,12 +150,12 @@ public:
     virtual bool get_exit_state() const;
     virtual bool is_key_pressed(unsigned char value) const;
     virtual unsigned char get_key_pressed() const;
+    virtual bool next_key_change(unsigned char& key, bool& pressed);
 
     // Implemented from tehBEEP
-    void copy_audio(uint8_t* data, int size);
+    void attach_tone(tehTONE* t);
     int get_sample_rate();
     int get_bytes_per_sample();
-    int get_buffer_size();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * @file chipperTRIPLE.h
+ * @author William Tradewell
+ * @brief A lock-free triple buffer, for handing frames from one thread to
+ *  another.
+ * @version 0.1
+ * @date 2026-10-17
+ */
+
+#ifndef CHIPPERTRIPLE_H_
+#define CHIPPERTRIPLE_H_
+
+#include <atomic>
+
+/**
+ * @brief Three buffers, passed between a producer and a consumer.
+ *
+ * The producer fills the back buffer, then publishes it, trading it for the
+ *  middle buffer. The consumer trades its front buffer for the middle buffer
+ *  whenever something new has been published. Neither side ever waits on the
+ *  other: the producer can publish as often as it likes, and the consumer
+ *  always gets the most recent buffer, skipping any it was too slow to see.
+ *
+ * @tparam T The type of buffer.
+ */
+template<class T>
+class chipperTRIPLE {
+private:
+    // Set in middle when it holds something the consumer hasn't taken yet.
+    static const int FRESH = 0x4;
+
+    T buffers[3];
+    // Index of the middle buffer, plus the FRESH bit. Shared by both sides.
+    std::atomic<int> middle;
+    // Index of the buffer the producer is filling.
+    int back;
+    // Index of the buffer the consumer is reading.
+    int front;
+
+public:
+    chipperTRIPLE() : middle(1), back(0), front(2) {}
+
+    /**
+     * @brief Returns the buffer to fill. Producer only.
+     *
+     * @return The back buffer.
+     */
+    T& get_back() {
+        return this->buffers[this->back];
+    }
+
+    /**
+     * @brief Hands the back buffer over to the consumer. Producer only.
+     *
+     * Whatever was in the middle becomes the new back buffer, so its contents
+     *  are stale, and must be written over.
+     */
+    void publish() {
+        this->back = this->middle.exchange(this->back | FRESH,
+                                           std::memory_order_acq_rel) & 0x3;
+        return;
+    }
+
+    /**
+     * @brief Takes the newest published buffer, if there is one. Consumer only.
+     *
+     * @return True if the front buffer changed, otherwise False.
+     */
+    bool update() {
+        bool result = false;
+        if (this->middle.load(std::memory_order_relaxed) & FRESH) {
+            this->front = this->middle.exchange(this->front,
+                                                std::memory_order_acq_rel) & 0x3;
+            result = true;
+        } // else, do_nothing();
+        return result;
+    }
+
+    /**
+     * @brief Returns the buffer to read. Consumer only.
+     *
+     * @return The front buffer.
+     */
+    const T& get_front() const {
+        return this->buffers[this->front];
+    }
+};
+
+#endif
@@ -1,141 +1,257 @@
 #include "tehAUDIO.h"
 
-tehAUDIO::tehAUDIO(tehBEEP& in) {
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+tehAUDIO::tehAUDIO(tehBEEP& in) : emulated_frame(0) {
     this->speaker = &in;
 
     this->toneHz = 200;
     this->toneVolume = 0xFFF;
 
     // Get the current sample-rate and sample size from the audio interface, and
-    // configure buffer parameters accordingly
+    // configure our tone accordingly
     this->samplesPerSecond = this->speaker->get_sample_rate();
     this->bytesPerSample = this->speaker->get_bytes_per_sample();
-    this->squareWavePeriod = this->samplesPerSecond / this->toneHz;
-    this->halfWavePeriod = this->squareWavePeriod / 2;
-    this->sampleCount = this->samplesPerSecond / 60;
-    this->bufferSize = (this->sampleCount * 4) * this->bytesPerSample;
-
-    this->runningSampleIndex = 0;
-    // Initialize, and allocate the RingBuffer.
-    this->buffer.Size = this->bufferSize;
-    this->buffer.writeCursor = 0;
-    this->buffer.playCursor = 0;
-    this->buffer.data = malloc(this->buffer.Size);
-
-    // Zero out buffer
-    for (int i = 0; i < this->buffer.Size ; i++) {
-        // Cast the pointer to Uint8, offset by i, and dereference
-        *((uint8_t*)this->buffer.data + i) = 0;
-    }
+    this->channels = this->bytesPerSample / sizeof(int16_t);
+    this->halfWavePeriod = ((uint64_t) this->samplesPerSecond << FRACTION_BITS)
+                         / (this->toneHz * 2);
+    this->latency = (this->samplesPerSecond / 60) * 2;
+    this->max_drift = (this->samplesPerSecond / 60) * 4;
+    this->build_steps();
+
+    this->frame = 0;
+    this->queued_on = false;
+    this->position = 0;
+    this->playing = false;
+    this->high = false;
+    this->next_flip = 0;
+    this->level = 0;
+    this->has_pending = false;
+    std::memset(this->deltas, 0, sizeof(this->deltas));
+    this->sum = 0;
+    this->settled = 0;
+
+    this->speaker->attach_tone(this);
 }
 
 tehAUDIO::~tehAUDIO() {
-    free(this->buffer.data);
+    this->speaker->attach_tone(NULL);
 }
 
-void tehAUDIO::sendDataToBuffer(int len) {
-    // Initialize with Case B
-    int Region1Size = len;
-    int Region2Size = 0;
-    // Test for Case A, overwrite if true
-    // We've gotta do a bit more math here than when we're generating, so 
-    // the logic's flipped around.
-    // CASE B NEVER FIRES OFF- Are we doing something wrong?
-    if (this->buffer.playCursor + len > this->buffer.Size) {
-        Region1Size = this->buffer.Size - this->buffer.playCursor;
-        Region2Size = len - Region1Size;
+/**
+ * A band-limited step is the running integral of a windowed sinc. We integrate
+ *   it once, finely, then read off how much of the step has arrived by each
+ *   sample it covers, for each phase it can start at.
+ *
+ * Samples are played STEP_WIDTH / 2 behind time, so a step at time t is half
+ *   way through the samples after t. Rounding is done on the running total,
+ *   not on each difference, so every row adds up to exactly one whole step,
+ *   and nothing is left over to drift.
+ */
+void tehAUDIO::build_steps() {
+    const double pi = 3.14159265358979323846;
+    const double cutoff = 0.9;
+    const int half = STEP_WIDTH / 2;
+    const int resolution = PHASES * 8;
+    const int points = STEP_WIDTH * resolution;
+    std::vector<double> integral(points + 1, 0.0);
+    for (int i = 1; i <= points; i++) {
+        double x = ((i - 0.5) / resolution) - half;
+        double sinc = (x == 0.0)
+            ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+        double window = 0.42 + (0.5 * std::cos(pi * x / half))
+                      + (0.08 * std::cos(2.0 * pi * x / half));
+        integral[i] = integral[i - 1] + (sinc * window);
     }
 
-    // Copy!
-    this->speaker->copy_audio((uint8_t*)(this->buffer.data) + this->buffer.playCursor, Region1Size);
-    this->speaker->copy_audio((uint8_t*)(this->buffer.data), Region2Size);
-    this->buffer.playCursor = (this->buffer.playCursor + len) % this->buffer.Size;
+    const int32_t whole = 1 << STEP_BITS;
+    for (int p = 0; p < PHASES; p++) {
+        int32_t arrived = 0;
+        for (int k = 0; k < STEP_WIDTH; k++) {
+            // Sample k sits at k + 1 - half - (p / PHASES) from the step.
+            int index = ((k + 1) * resolution) - (p * (resolution / PHASES));
+            int32_t total = (k == STEP_WIDTH - 1) ? whole
+                : (int32_t) std::floor(
+                    ((integral[index] / integral[points]) * whole) + 0.5);
+            this->steps[p][k] = total - arrived;
+            arrived = total;
+        }
+    }
     return;
 }
 
+uint64_t tehAUDIO::frame_to_time(uint64_t f) {
+    return ((f * this->samplesPerSecond) << FRACTION_BITS) / 60;
+}
+
 /**
- * NOTICE:
- * 
- * Either the output of this function is incorrect, audio playback is too in 
- *   Windows, or WINE is exhibiting an unknown issue. The tone sounds higher 
- *   pitched than it should.
+ * If the ring is full, the change simply isn't queued yet. We keep trying
+ *   every frame, until it is, or until the tone changes back.
  */
+void tehAUDIO::queue_event(bool on, uint64_t time) {
+    if (this->queued_on != on) {
+        tone_event event = { time, on };
+        if (this->events.push(&event, 1) == 1) {
+            this->queued_on = on;
+        } // else, do_nothing();
+    } // else, do_nothing();
+    return;
+}
 
-void tehAUDIO::GenerateSamples(bool mute) {
-    // Initialize with Case A - The Play Cursor is ahead of the Write Cursor
-    // In case A, we generate samples up to the play cursor in one contiguous 
-    //  block
-    int W1 = this->buffer.playCursor - this->buffer.writeCursor;
-    int W2 = 0;
-    // Test for Case B - The Play cursor is behind Write Cursor
-    if (this->buffer.writeCursor > this->buffer.playCursor) {
-    // In case B, we generate samples up to the end of the buffer, and then 
-    // generate samples from the beginning of the buffer, up to the play cursor.
-        W1 = this->buffer.Size - this->buffer.writeCursor;
-        W2 = this->buffer.playCursor;
-    }
+/**
+ * Events can only be looked at by popping them, so the one we looked at is held
+ *   onto until it's due.
+ */
+bool tehAUDIO::peek_event(uint64_t& time) {
+    if (!this->has_pending) {
+        this->has_pending = (this->events.pop(&this->pending, 1) == 1);
+    } // else, do_nothing();
+    if (this->has_pending) {
+        time = this->pending.time;
+    } // else, do_nothing();
+    return this->has_pending;
+}
 
-    int16_t sampleValue = 0; // Holds the evaluated sample value in our loops.
-
-    // This one... Is fun.
-    // Our Ring Buffer object holds the audio data as a void pointer to a pre-
-    //  allocated block of memory. We use (Uint8*) to cast this void pointer to
-    //  a 8-bit pointer. The specific type isn't important, as the width.
-    // When we iterate that pointer, it will progress in 8 bit steps. This gets
-    //  us a pointer to the right location.
-    // Then, we cast the pointer to int16_t- The same type as our audio samples.
-    //  This lets us iterate cleanly forwards along the buffer when generating
-    //  audio.
-    int16_t* dest = 
-        (int16_t*)((uint8_t*)(this->buffer.data) + this->buffer.writeCursor);
-
-    // If mute is true, zero out tone, otherwise, set it to 
-    int tone = (mute) ? 0 : this->toneVolume;
-
-    // We have duplicate logic here! While we could split this part into its own
-    //  function, this is already a time-critical task, and we don't need the 
-    //  extra overhead.
-
-    // The number of samples we need to generate can be calculated by dividing
-    //  the size of the desired amount of buffer by the size, in bytes a single
-    //  sample takes up.
-    int samples = W1 / this->bytesPerSample;
-
-    // Generating samples is dead simple, now that we know where to start, and
-    //  how far to go. Each loop, we determine if the waveform is high, or low-
-    //  And then generate the sample twice- Necessary for stereo audio.
-    for (int i = 0; i < samples; i++) {
-        sampleValue = 
-            ((this->runningSampleIndex++ / this->halfWavePeriod) % 2)
-                ? tone : -tone;
-        *dest++ = sampleValue;
-        *dest++ = sampleValue;
-    }
+void tehAUDIO::add_step(uint64_t time, int to) {
+    int delta = to - this->level;
+    this->level = to;
+    if (delta != 0) {
+        uint64_t first = (time >> FRACTION_BITS) + 1;
+        const int32_t* step
+            = this->steps[(time >> (FRACTION_BITS - PHASE_BITS)) & (PHASES - 1)];
+        for (int k = 0; k < STEP_WIDTH; k++) {
+            this->deltas[(first + k) & (DELTA_SIZE - 1)] += delta * step[k];
+        }
+        this->settled = std::max(this->settled, first + STEP_WIDTH);
+    } // else, do_nothing();
+    return;
+}
 
-    // For case B set dest to the beginning of the data buffer.
-    dest = (int16_t*)(this->buffer.data);
+/**
+ * A step can't be placed before the last sample we've already played, so any
+ *   event that arrives late is played as soon as it can be. The wave starts
+ *   over from its high half every time the tone starts, so every beep sounds
+ *   the same.
+ */
+uint64_t tehAUDIO::run_steps(uint64_t time) {
+    const uint64_t none = UINT64_MAX;
+    uint64_t earliest = (time >= ONE_SAMPLE) ? time - ONE_SAMPLE : 0;
+    uint64_t result = none;
+    bool stepping = true;
+    while (stepping) {
+        uint64_t event = none;
+        if (!this->peek_event(event)) {
+            event = none;
+        } // else, do_nothing();
+        uint64_t flip = (this->playing) ? this->next_flip : none;
+        if (flip < time && flip <= event) {
+            this->high = !this->high;
+            this->add_step(flip, (this->high)
+                ? this->toneVolume : -this->toneVolume);
+            this->next_flip += this->halfWavePeriod;
+        } else if (event < time) {
+            event = std::max(event, earliest);
+            this->has_pending = false;
+            if (this->pending.on && !this->playing) {
+                this->playing = true;
+                this->high = true;
+                this->next_flip = event + this->halfWavePeriod;
+                this->add_step(event, this->toneVolume);
+            } else if (!this->pending.on && this->playing) {
+                this->playing = false;
+                this->add_step(event, 0);
+            } // else, do_nothing();
+        } else {
+            result = std::min(flip, event);
+            stepping = false;
+        }
+    }
+    return result;
+}
 
-    // Repeat for section two. If section two is empty, no logic will be execu-
-    //  ted here.
-    samples = W2 / this->bytesPerSample;
+/**
+ * Credit to David Gow's Handmade Penguin tutorial, Getting Circular with SDL
+ *   Audio by Eric Scrivner, and to LazyFoo's SDL tutorial, with which I kludged
+ *   together the original, push based version of this!
+ *   https://lazyfoo.net/tutorials/SDL/
+ *   https://davidgow.net/handmadepenguin/ch8.html
+ *   https://ericscrivner.me/2017/10/getting-circular-sdl-audio/
+ *
+ * Before generating anything, we check how far behind the emulator we are. If
+ *   we have drifted too far either way, we jump straight to where we should be.
+ *   Events we jump over still take effect, just all at once.
+ *
+ * Samples come out in runs. Wherever no step is still settling, and none is
+ *   due, the output is flat, and the whole run is filled in one go. Only the
+ *   few samples around each step are summed one at a time.
+ */
+void tehAUDIO::generate_samples(int16_t* data, int count) {
+    uint64_t target = this->frame_to_time(
+        this->emulated_frame.load(std::memory_order_acquire)) >> FRACTION_BITS;
+    target = (target > (uint64_t) this->latency) ? target - this->latency : 0;
+    if (this->position + this->max_drift < target
+     || this->position > target + this->max_drift) {
+        this->position = target;
+        std::memset(this->deltas, 0, sizeof(this->deltas));
+        this->sum = this->level * (1 << STEP_BITS);
+        this->settled = this->position;
+        if (this->playing) {
+            this->next_flip = (this->position << FRACTION_BITS)
+                            + this->halfWavePeriod;
+        } // else, do_nothing();
+    } // else, do_nothing();
 
-    for (int i = 0; i < samples; i++) {
-        sampleValue =
-            ((this->runningSampleIndex++ / this->halfWavePeriod) % 2)
-                ? tone : - tone;
-        *dest++ = sampleValue;
-        *dest++ = sampleValue;
+    uint64_t end = this->position + count;
+    while (this->position < end) {
+        uint64_t next = this->run_steps(this->position << FRACTION_BITS);
+        uint64_t stop = end;
+        if (next != UINT64_MAX) {
+            stop = std::min(stop, (next >> FRACTION_BITS) + 1);
+        } // else, do_nothing();
+        if (this->position >= this->settled) {
+            int run = (int) (stop - this->position) * this->channels;
+            std::fill_n(data, run, (int16_t) (this->sum >> STEP_BITS));
+            data += run;
+            this->position = stop;
+        } else {
+            stop = std::min(stop, this->settled);
+            for (; this->position < stop; this->position++) {
+                int32_t& delta
+                    = this->deltas[this->position & (DELTA_SIZE - 1)];
+                this->sum += delta;
+                delta = 0;
+                int16_t sampleValue = (int16_t) (this->sum >> STEP_BITS);
+                for (int c = 0; c < this->channels; c++) {
+                    *data++ = sampleValue;
+                }
+            }
+        }
     }
-
-    // After everything is over, we should be all caught up!
-    this->buffer.writeCursor = this->buffer.playCursor;
     return;
 }
 
-
 void tehAUDIO::SoundTick(bool mute) {
-    this->GenerateSamples(mute);
-    int length = this->buffer.Size - this->speaker->get_buffer_size();
-    this->sendDataToBuffer(length);
+    this->frame++;
+    this->queue_event(!mute, this->frame_to_time(this->frame));
+    this->emulated_frame.store(this->frame, std::memory_order_release);
+    return;
+}
+
+/**
+ * The cycle is scaled to where it falls between this frame's first sample, and
+ *   the next frame's, so the change lands as close as we can tell to when it
+ *   would have been heard.
+ */
+void tehAUDIO::SoundEdge(bool on, int cycle, int cycles) {
+    uint64_t start = this->frame_to_time(this->frame);
+    uint64_t time = start;
+    if (cycles > 0) {
+        time += ((this->frame_to_time(this->frame + 1) - start) * cycle)
+              / cycles;
+    } // else, do_nothing();
+    this->queue_event(on, time);
     return;
-}
\ No newline at end of file
+}
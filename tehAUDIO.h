@@ -2,7 +2,7 @@
  * @file tehAUDIO.h
  * @author William Tradewell
  * @brief This class provides our CHIP-8 beeper emulation.
- * @version 0.1
+ * @version 0.3
  * @date 2026-03-30
  */
 
@@ -10,76 +10,198 @@
 #define TEH_AUDIO_H_
 
 #include "tehBEEP.h"
+#include "tehTONE.h"
+#include "chipperRING.h"
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 
-class tehAUDIO {
+/**
+ * @brief tehAUDIO turns the sound timer into a tone.
+ *
+ * The emulator tells us whenever the tone starts, or stops, and how many cycles
+ *  into the frame that was. We queue up an event, stamped with the exact point
+ *  in the audio stream it lands on. The speaker then pulls samples from us,
+ *  through tehTONE, on its own thread, playing the events back at the times
+ *  they're stamped with. Once a frame, the emulator also tells us the frame is
+ *  over, which is what keeps the two in step.
+ *
+ * The audio thread trails the emulator by a couple of frames, so that events
+ *  are always queued up before they're due. If the two drift too far apart,
+ *  say because the emulator was held up, or is running in turbo, the audio
+ *  thread jumps to catch up, rather than letting the delay grow.
+ *
+ * Every step in the output, whether it's the square wave flipping, or the tone
+ *  starting or stopping, is drawn from a table of band-limited steps, so that
+ *  it lands between samples exactly where it should, without aliasing. Between
+ *  steps, the output is flat, and is filled in a whole run at a time.
+ */
+class tehAUDIO: public tehTONE {
 private:
-    tehBEEP *speaker;
+    // Times are kept in fixed point, in samples since the first frame.
+    static const int FRACTION_BITS = 16;
+    static const uint64_t ONE_SAMPLE = 1ULL << FRACTION_BITS;
+    // How many positions between two samples a step can be placed at.
+    static const int PHASE_BITS = 5;
+    static const int PHASES = 1 << PHASE_BITS;
+    // How many samples a single step is spread over.
+    static const int STEP_WIDTH = 16;
+    // Steps are added to the output in this fixed point scale.
+    static const int STEP_BITS = 15;
+    // Must be a power of two, and longer than STEP_WIDTH.
+    static const int DELTA_SIZE = 32;
 
-    // Variables used for our ring buffer
-    // Credit to David Gow's Handmade Penguin tutorial, Getting Circular with
-    //  SDL Audio by Eric Scrivner, and to LazyFoo's SDL tutorial, with which I 
-    //  kludged together something that barely works!
-    // https://lazyfoo.net/tutorials/SDL/
-    // https://davidgow.net/handmadepenguin/ch8.html
-    // https://ericscrivner.me/2017/10/getting-circular-sdl-audio/
-
-    struct audio_ring_buffer {
-        int Size; // Size of our buffer, in bytes
-        int writeCursor; // Where we will insert data into our buffer
-        int playCursor; // Where we will read data from the buffer
-        void *data;
+    // A change in the tone, and where it lands in the stream.
+    struct tone_event {
+        uint64_t time;
+        bool on;
     };
 
-    audio_ring_buffer buffer;
-        // CONSTANT BLOCK
+    tehBEEP *speaker;
+
+    // Shared between both threads. Everything the audio thread knows about the
+    //  emulator comes through these two.
+    chipperRING<tone_event, 256> events;
+    // The latest frame the emulator has finished.
+    std::atomic<uint64_t> emulated_frame;
+
+    // Emulation side. The number of frames so far.
+    uint64_t frame;
+    // Emulation side. Whether the last event we queued turned the tone on.
+    bool queued_on;
+
+    // Audio side. Where playback is, in whole samples since the first frame.
+    uint64_t position;
+    // Audio side. Whether the tone is currently playing.
+    bool playing;
+    // Audio side. Whether the square wave is in its high half.
+    bool high;
+    // Audio side. When the square wave next flips.
+    uint64_t next_flip;
+    // Audio side. The level every step so far has settled on.
+    int level;
+    // Audio side. An event that was popped before it was due.
+    tone_event pending;
+    bool has_pending;
+    // Audio side. The difference between each upcoming sample, and the one
+    //  before it, in STEP_BITS fixed point, indexed by position. The output is
+    //  the running sum.
+    int32_t deltas[DELTA_SIZE];
+    int32_t sum;
+    // Audio side. From this sample on, every delta is zero.
+    uint64_t settled;
+
+    // CONSTANT BLOCK
     // These vars define our audio output.
     int samplesPerSecond;
     // for 16 bit, stereo audio, that's 4 bytes per sample
-    int bytesPerSample; 
+    int bytesPerSample;
+    // Number of interleaved values in each sample.
+    int channels;
     // These vars define our tone.
     int toneHz;
     short int toneVolume;
-    int squareWavePeriod;
-    int halfWavePeriod;
-    // These vars define our buffers.
-    int sampleCount;
-    int bufferSize;
+    // Half of a wave, in fixed point.
+    uint64_t halfWavePeriod;
+    // How far, in samples, playback trails the emulator.
+    int latency;
+    // How far, in samples, playback may drift before it jumps to catch up.
+    int max_drift;
+    // Each step, at each phase, as the difference it makes to each sample it
+    //  covers. Each row sums to exactly 1 << STEP_BITS.
+    int32_t steps[PHASES][STEP_WIDTH];
 
-    // Keep this one around always increasing (and looping), so we have
-    //   a constant tone.
-    unsigned int runningSampleIndex;
+    /**
+     * @brief Fills the step table with band-limited steps.
+     */
+    void build_steps();
+
+    /**
+     * @brief Returns the time a frame starts at.
+     *
+     * @param f The frame.
+     * @return The time, in fixed point samples.
+     */
+    uint64_t frame_to_time(uint64_t f);
+
+    /**
+     * @brief Queues a change in the tone. Emulation thread only.
+     *
+     * @param on Whether the tone is now playing.
+     * @param time When it changed, in fixed point samples.
+     */
+    void queue_event(bool on, uint64_t time);
+
+    /**
+     * @brief Looks at the next event, without taking it.
+     *
+     * @param time Where to put the time it's due.
+     * @return True if there is an event, otherwise False.
+     */
+    bool peek_event(uint64_t& time);
+
+    /**
+     * @brief Moves the output to a new level, at a point between two samples.
+     *
+     * @param time When the step happens, in fixed point samples.
+     * @param to The level to step to.
+     */
+    void add_step(uint64_t time, int to);
+
+    /**
+     * @brief Plays every step due before a sample.
+     *
+     * @param time The sample, in fixed point.
+     * @return The time of the step after those, or UINT64_MAX if there's none.
+     */
+    uint64_t run_steps(uint64_t time);
 
-    void sendDataToBuffer(int len);
 public:
-    
+
+    /**
+     * @brief Sets up the tone, and attaches it to the speaker.
+     *
+     * @param in The speaker to play through.
+     */
     tehAUDIO(tehBEEP& in);
 
+    /**
+     * @brief Detaches from the speaker.
+     */
     ~tehAUDIO();
 
     /**
-     * @brief Fill buffer with audio.
-     * 
-     * Generates silence when mute is true, and a square wave when mute is false. 
-     * 
-     * Writes sound data into a ring buffer.
-     * 
-     * @param bool Mute on true, beep on false.
+     * @brief Fill buffer with audio. Audio thread only.
+     *
+     * Generates silence while the tone is off, and a square wave while it's on,
+     *  switching between the two as each event falls due.
+     *
+     * @param data Where to write the samples.
+     * @param count The number of samples to write, per channel.
      */
-    void GenerateSamples(bool mute);
+    void generate_samples(int16_t* data, int count);
 
     /**
-     * @brief If necessary, fill the sound buffer.
-     * 
-     * This function, when implemented, should fill an audio buffer with either a 
-     * square tone, or silence.
-     * 
-     * @param bool Mute on true, beep on false.
+     * @brief Ends a frame. Emulation thread only.
+     *
+     * This should be called exactly once per emulated frame, since the frames
+     *  are what events are timed by.
+     *
+     * @param mute Mute on true, beep on false.
      */
     void SoundTick(bool mute);
 
+    /**
+     * @brief Starts, or stops the tone partway through a frame. Emulation
+     *  thread only.
+     *
+     * @param on Beep on true, mute on false.
+     * @param cycle How many cycles into the frame the change happened.
+     * @param cycles How many cycles the frame runs for.
+     */
+    void SoundEdge(bool on, int cycle, int cycles);
+
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,7 +2,7 @@
  * @file tehBEEP.h
  * @author William Tradewell
  * @brief A virtual interface for handling audio output.
- * @version 0.2
+ * @version 0.3
  * @date 2026-03-27
  */
 
@@ -11,29 +11,31 @@
 
 #include <cstdint>
 
+#include "tehTONE.h"
+
 /**
  * @brief tehBOOP is a virtual interface for handling audio output.
  * 
  * This class is a virtual interface that defines a minimum viable set of
  *  functions needed to send audio to an output device.
  * 
- * This interface assumes an audio API that is capable of copying given data
- *  into a buffer. 
+ * This interface assumes an audio API that asks for data when it needs it, 
+ *  rather than having data pushed at it. Audio is pulled from a tehTONE.
  */
 class tehBEEP {
     public:
     virtual ~tehBEEP() {}
     
 /**
- * @brief Copy the given data to the sound buffer.
+ * @brief Sets where the sound buffer is filled from.
  * 
- * Given a pointer to a data buffer, and the size of that buffer, copy the data
- *  to the implementation's sound buffer.
+ * From then on, the implementation calls generate_samples() whenever it needs
+ *  more audio, from whatever thread it likes. Once this returns, the previous
+ *  tehTONE is never called again, so it's safe to destroy.
  * 
- * @param data Pointer to the sound data to be copied.
- * @param size Number of bytes to copy to the sound buffer.
+ * @param tone The source of all audio, or NULL for silence.
  */
-    virtual void copy_audio(uint8_t* data, int size) = 0;
+    virtual void attach_tone(tehTONE* tone) = 0;
 
 /**
  * @brief Returns the configured sample rate.
@@ -48,13 +50,6 @@ class tehBEEP {
  * @return The size in bytes of any audio sample.
  */
     virtual int get_bytes_per_sample() = 0;
-
-/**
- * @brief Returns the size in bytes of queued audio in the buffer.
- * 
- * @return The size in bytes of queued audio in the buffer.
- */
-    virtual int get_buffer_size() = 0;
 };
 
 #endif
@@ -50,6 +50,22 @@ public:
      * @returns A character representing the first valid keycode.
      */
     virtual unsigned char get_key_pressed() const = 0;
+
+    /**
+     * @brief Takes the oldest key press, or release, that hasn't been taken.
+     * 
+     * This lets a caller see taps that are over before it next looks at the
+     *  keys. Implementations that only know which keys are held can leave this
+     *  as it is, and callers should fall back on is_key_pressed().
+     * 
+     * @param key Where to put the key, from 0x0 to 0xF.
+     * @param pressed Where to put True for a press, or False for a release.
+     * @returns True if there was a change to take, otherwise False.
+     */
+    virtual bool next_key_change(unsigned char& /* key */,
+                                 bool& /* pressed */) {
+        return false;
+    }
 };
 
 #endif
\ No newline at end of file
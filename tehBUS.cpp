@@ -3,17 +3,17 @@
 tehBUS::tehBUS(tehSCREEN& s, tehBEEP& b, tehBOOP& k, chippy::systype sys) 
                  : screen(s)
                  , speaker(b)
-                 , keyboard(k) {
+                 , keyboard(k)
+                 // XO-CHIP can address all 64KB. Everything else gets 4KB.
+                 , memory((sys == chippy::XOCHIP) ? 0x10000 : 0x1000) {
     this->system = sys;
-    this->memory = new tehRAMS();
     this->framebuffer = new tehVIDEO(s, sys);
     this->audiobuffer = new tehAUDIO(b);
-    this->speakerState = true; // start muted
+    this->snoop = NULL;
     return;
 }
 
 tehBUS::~tehBUS() {
-    delete(this->memory);
     delete(this->framebuffer);
     delete(this->audiobuffer);
     return;
@@ -23,8 +23,6 @@ void tehBUS::clock_bus() {
     this->keyboard.process_events();
     this->framebuffer->update_screen();
     // this->screen.refresh_screen();
-    this->audiobuffer->SoundTick(this->speakerState);
-    this->speakerState = true;
     return;
 }
 
@@ -32,15 +30,35 @@ bool tehBUS::get_exit_state() {
     return this->keyboard.get_exit_state();
 }
 
-unsigned char tehBUS::read_ram(int addr) {
-    return this->memory->read_ram(addr);
+void tehBUS::attach_snoop(tehSNOOP& s) {
+    this->snoop = &s;
+    return;
+}
+
+void tehBUS::read_span(int addr, unsigned char* data, int len) {
+    this->memory.read_span(addr, data, len);
+    return;
 }
 
-void tehBUS::write_ram(int addr, unsigned char val) {
-    this->memory->write_ram(addr, val);
+/**
+ * A run that goes past the top of the address space wraps back around to 0 in
+ *   RAM, so the snoop is told about the addresses that were actually written.
+ */
+void tehBUS::write_span(int addr, const unsigned char* data, int len) {
+    this->memory.write_span(addr, data, len);
+    if (this->snoop != NULL) {
+        for (int i = 0; i < len; i++) {
+            this->snoop->snoop_write(
+                (int) ((addr + i) & (tehRAMS::MAX_SIZE - 1)));
+        }
+    } // else do_nothing();
     return;
 }
 
+int tehBUS::get_ram_size() {
+    return (int) this->memory.get_size();
+}
+
 void tehBUS::blank_screen() {
     this->framebuffer->blank_screen();
     return;
@@ -51,19 +69,52 @@ void tehBUS::set_video_mode(bool mode) {
     return;
 }
 
-bool tehBUS::copy_sprite(int x, int y, short int addr, int len) {
-    bool flipped = false;
-    // Copy memory containing sprite into bool array
-    unsigned char sprite[32] = {0};
-    // if length is 16, we're always copying 32 bytes of memory. This is a
-    // special case for SUPERCHIP's 16x16 sprite drawing
-    int length = (len == 16) ? 32 : len;
-    for (int i = 0; i < length ; i++) {
-        sprite[i] = this->memory->read_ram(addr+i);
-    }
+void tehBUS::select_planes(int mask) {
+    this->framebuffer->select_planes(mask);
+    return;
+}
+
+bool tehBUS::get_video_mode() {
+    return this->framebuffer->get_video_mode();
+}
+
+void tehBUS::scroll_down(int n) {
+    this->framebuffer->scroll_down(n);
+    return;
+}
+
+void tehBUS::scroll_right(int n) {
+    this->framebuffer->scroll_right(n);
+    return;
+}
+
+void tehBUS::scroll_left(int n) {
+    this->framebuffer->scroll_left(n);
+    return;
+}
+
+void tehBUS::set_clipping(bool mode) {
+    this->framebuffer->set_clipping(mode);
+    return;
+}
+
+int tehBUS::copy_sprite(int x, int y, int addr, int len) {
+    int rows = 0;
+    // Only used if the sprite wraps around the end of memory.
+    unsigned char spill[64];
+    // if length is 16, we're always reading 32 bytes of memory. This is a
+    // special case for SUPERCHIP's 16x16 sprite drawing. XO-CHIP needs that
+    // much again for every other plane it draws to.
+    int length = ((len == 16) ? 32 : len) 
+               * this->framebuffer->get_selected_planes();
+
+    rows = this->framebuffer->draw_sprite(x, y, len, 
+                                          this->view_span(addr, length, spill));
+    return rows;
+}
 
-    flipped = this->framebuffer->draw_sprite(x, y, len, sprite);
-    return flipped;
+uint64_t tehBUS::hash_framebuffer() {
+    return this->framebuffer->hash_framebuffer();
 }
 
 unsigned char tehBUS::get_key() {
@@ -74,7 +125,12 @@ bool tehBUS::test_key(unsigned char value) {
     return this->keyboard.is_key_pressed(value);
 }
 
-void tehBUS::screm() {
-    this->speakerState = false;
+void tehBUS::screm(bool on) {
+    this->audiobuffer->SoundTick(!on);
+    return;
+}
+
+void tehBUS::screm(bool on, int cycle, int cycles) {
+    this->audiobuffer->SoundEdge(on, cycle, cycles);
     return;
 }
@@ -16,6 +16,7 @@
 #include "tehSCREEN.h"
 #include "tehBOOP.h"
 #include "tehBEEP.h"
+#include "tehSNOOP.h"
 
 /**
  * @brief tehBUS connects all of our interfaces together.
@@ -34,7 +35,8 @@
  * 
  * Whenever the bus is clocked with clock_bus(), routines are called to update
  *  the states of the relevant peripheral devices - This allows us to update the
- *  screen, play audio, and handle user events.
+ *  screen, and handle user events. Audio is pulled by the speaker itself, and
+ *  only needs screm() once a frame, plus whenever the tone changes mid-frame.
  * 
  * @see tehBUS()
  */
@@ -43,10 +45,10 @@ private:
     tehSCREEN& screen;
     tehBEEP& speaker;
     tehBOOP& keyboard;
-    tehRAMS* memory;
+    tehRAMS memory;
     tehVIDEO* framebuffer;
     tehAUDIO* audiobuffer;
-    bool speakerState;
+    tehSNOOP* snoop;
 
     chippy::systype system;
 
@@ -83,6 +85,13 @@ public:
      */
     bool get_exit_state();
 
+    /**
+     * @brief Attaches an observer that is told about every RAM write.
+     * 
+     * @param s Any class that implements tehSNOOP.
+     */
+    void attach_snoop(tehSNOOP& s);
+
     // Memory
     
     /**
@@ -96,11 +105,53 @@ public:
     /**
      * @brief Writes a value to RAM.
      * 
+     * If a tehSNOOP is attached, it is told about the write afterwards.
+     * 
      * @param addr The address to write to.
      * @param val The data to write.
      */
     void write_ram(int addr, unsigned char val);
 
+    /**
+     * @brief Reads a run of bytes from RAM, in one go.
+     * 
+     * @param addr The address to start reading from.
+     * @param data Where to copy the bytes to.
+     * @param len The number of bytes to read.
+     */
+    void read_span(int addr, unsigned char* data, int len);
+
+    /**
+     * @brief Returns a pointer to a run of bytes in RAM.
+     * 
+     * This points straight into RAM, unless the run wraps around the end of
+     *  the address space, in which case it's copied into spill first.
+     * 
+     * @param addr The address the run starts at.
+     * @param len The number of bytes in the run.
+     * @param spill Somewhere to copy the run to, at least len bytes long.
+     * @return A pointer to len bytes of RAM. Don't hold onto it.
+     */
+    const unsigned char* view_span(int addr, int len, unsigned char* spill);
+
+    /**
+     * @brief Writes a run of bytes to RAM, in one go.
+     * 
+     * If a tehSNOOP is attached, it is told about every byte afterwards.
+     * 
+     * @param addr The address to start writing to.
+     * @param data The bytes to write.
+     * @param len The number of bytes to write.
+     */
+    void write_span(int addr, const unsigned char* data, int len);
+
+    /**
+     * @brief Returns the size of RAM.
+     * 
+     * @return The number of addressable bytes.
+     */
+    int get_ram_size();
+
     // Video
 
     /**
@@ -116,14 +167,66 @@ public:
     void set_video_mode(bool mode);
 
     /**
-     * @brief Copies sprite data from RAM into the framebuffer.
+     * @brief Selects the planes that are drawn to, in XO-CHIP quirks mode.
+     * 
+     * @param mask One bit per plane, starting with the first in bit 0.
+     */
+    void select_planes(int mask);
+
+    /**
+     * @brief Returns whether pixel doubling is in effect.
+     * 
+     * @return True if we are in low resolution mode, otherwise False.
+     */
+    bool get_video_mode();
+
+    /**
+     * @brief Scrolls the framebuffer down.
+     * 
+     * @param n The number of pixels to scroll by.
+     */
+    void scroll_down(int n);
+
+    /**
+     * @brief Scrolls the framebuffer right.
+     * 
+     * @param n The number of pixels to scroll by.
+     */
+    void scroll_right(int n);
+
+    /**
+     * @brief Scrolls the framebuffer left.
+     * 
+     * @param n The number of pixels to scroll by.
+     */
+    void scroll_left(int n);
+
+    /**
+     * @brief Toggles sprite clipping at the edges of the screen.
+     * 
+     * @param mode If True, sprites are clipped, otherwise they wrap around.
+     */
+    void set_clipping(bool mode);
+
+    /**
+     * @brief Draws sprite data from RAM into the framebuffer.
+     * 
+     * The sprite is read straight out of RAM, without copying it first.
      * 
      * @param x The X position to copy the sprite to.
      * @param y The Y position to copy the sprite to.
      * @param addr The memory address to copy the sprite from.
      * @param len The size of the sprite.
+     * @return The number of sprite rows that collided, or were clipped.
      */
-    bool copy_sprite(int x, int y, short int addr, int len);
+    int copy_sprite(int x, int y, int addr, int len);
+    
+    /**
+     * @brief Returns a hash of everything in the framebuffer.
+     * 
+     * @return A 64 bit hash of every plane.
+     */
+    uint64_t hash_framebuffer();
     
     // Input
 
@@ -145,9 +248,44 @@ public:
     // Audio
 
     /**
-     * @brief Tells the speaker to beep.
+     * @brief Tells the speaker whether to beep, for the frame just finished.
+     * 
+     * This must be called exactly once per emulated frame, since the speaker
+     *  keeps time by it.
+     * 
+     * @param on If True, the tone plays, otherwise it's silent.
      */
-    void screm();
+    void screm(bool on);
+
+    /**
+     * @brief Starts, or stops, the tone partway through a frame.
+     * 
+     * @param on If True, the tone plays, otherwise it's silent.
+     * @param cycle How many cycles into the frame the change happened.
+     * @param cycles How many cycles the frame runs for.
+     */
+    void screm(bool on, int cycle, int cycles);
 };
 
+/**
+ * Every fetch, and every byte an instruction touches, comes through these two,
+ *   so they are defined here where tehCPUS can inline them.
+ */
+inline unsigned char tehBUS::read_ram(int addr) {
+    return this->memory.read_ram(addr);
+}
+
+inline void tehBUS::write_ram(int addr, unsigned char val) {
+    this->memory.write_ram(addr, val);
+    if (this->snoop != NULL) {
+        this->snoop->snoop_write(addr);
+    } // else do_nothing();
+    return;
+}
+
+inline const unsigned char* tehBUS::view_span(int addr, int len, 
+                                              unsigned char* spill) {
+    return this->memory.view_span(addr, len, spill);
+}
+
 #endif
\ No newline at end of file
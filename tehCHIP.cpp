@@ -2,11 +2,21 @@
 
 using namespace chippy;
 
-tehCHIP::tehCHIP(tehSCREEN& s, tehBEEP& b, tehBOOP& k, systype opMode) {
+tehCHIP::tehCHIP(tehSCREEN& s, tehBEEP& b, tehBOOP& k, systype opMode,
+                 coretype c, unsigned int quirks) {
     this->operating_mode = opMode;
     this->bus = new tehBUS(s, b, k, opMode);
-    this->processor = new tehCPUS(*this->bus, opMode);
+    this->bus->set_clipping((quirks & QUIRK_CLIPPING) != 0);
+    this->processor = new tehCPUS(*this->bus, opMode, quirks);
+    this->processor->set_core(c);
     this->disk = NULL;
+    this->instructions_per_second = 1000;
+    this->cycle_remainder = 0;
+    this->turbo = false;
+    this->instructions_run = 0;
+    this->seconds_run = 0.0;
+    this->frame_limit = 0;
+    this->cycle_limit = 0;
     this->reset_system();
     return;
 }
@@ -22,58 +32,192 @@ void tehCHIP::load_program(std::string filename) {
     std::string output = "";
     // NOTE: 0x000-0x1FF reserved for system.
     int current_address = 0x200; // Start of Chip-8 program memory
+    // XO-CHIP programs can fill all 64KB, everything else has 4KB.
+    int end_address = this->bus->get_ram_size();
     do {
         output = this->disk->read_next_chunk();
-        for (int i = 0; i < (int) output.size() ; i++) {
-            this->bus->write_ram(current_address++, output[i]);
-        }
+        int len = (int) output.size();
+        if (len > end_address - current_address) {
+            if (len > 0 && current_address < end_address) {
+                std::cout << "ROM does not fit in memory, truncating." 
+                          << std::endl;
+            } // else do_nothing();
+            len = end_address - current_address;
+        } // else do_nothing();
+        this->bus->write_span(current_address, 
+            (const unsigned char*) output.data(), len);
+        current_address += len;
     } while (!this->disk->get_eof());
     // Destroy tehROM class object.
     delete disk;
 }
 
+/**
+ * Frames are scheduled against absolute deadlines, exactly 1/60th of a second
+ *   apart, rather than against however long the last frame took. A late frame
+ *   makes the next wait shorter, instead of pushing every later frame back,
+ *   and the number of instructions in a frame never depends on how late it is.
+ * 
+ * If we ever fall more than a few frames behind, say after the window has been
+ *   dragged around, we give up on the frames we missed instead of racing 
+ *   through them to catch up.
+ * 
+ * In turbo mode, we never wait. Frames run back to back, with the timers 
+ *   counting down after every one, and the deadlines only decide which frames
+ *   get to clock the bus.
+ */
 void tehCHIP::execute()  {
-    std::chrono::time_point<std::chrono::steady_clock> start, end;
-    start = std::chrono::steady_clock::now();
-    end = start;
-    // resolution of system clock is different from platform to platform
-    // auto delta 
-    //    = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    std::chrono::milliseconds delta;
+    const std::chrono::steady_clock::duration frame 
+        = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<long long, std::ratio<1, 60>>(1));
+    std::chrono::steady_clock::time_point start 
+        = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point deadline = start + frame;
+    unsigned long int frames = 0;
+    this->instructions_run = 0;
 
     // while (!this->processor.halt() & !this->screen.update_state()) {
-    while (!this->bus->get_exit_state()) {
-        delta 
-           = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        // TODO: After implementing toggle for vblank quirk, work out some math
-        //   to make clock speed easily tweakable. As it stands, this looks
-        //   pretty gnarly.
-        if (delta > std::chrono::milliseconds(16)) {
-            for (auto i = 0; 
-                 i < ((1000000 * (int) delta.count()) / 1000000);
-                 i++) 
-            {
-                // SDL_Log("Clock %d", i);
-                this->processor->clock_sys();
-            }
+    while (!this->bus->get_exit_state() 
+        && ((this->frame_limit == 0) || (frames < this->frame_limit))
+        && ((this->cycle_limit == 0) 
+         || (this->instructions_run < this->cycle_limit))) {
+        bool due = !this->turbo 
+                || (std::chrono::steady_clock::now() >= deadline);
+        int cycles = this->next_frame_cycles();
+        if ((this->cycle_limit != 0) 
+         && ((unsigned long long int) cycles 
+             > this->cycle_limit - this->instructions_run)) {
+            cycles = (int) (this->cycle_limit - this->instructions_run);
+        } // else, do_nothing();
+        this->instructions_run += this->processor->run(cycles);
 
+        if (due) {
             this->bus->clock_bus();
             // this->screen.refresh_screen();
-            this->processor->clock_60hz();
-            start = std::chrono::steady_clock::now();
         } // else, do_nothing();
+        this->processor->clock_60hz();
         this->processor->set_sound();
-        // Sleeping for 0 milliseconds tells the task scheduler that we're
-        //   ceding compute time to other processes. 'I can afford to wait'- But
-        //   it allows for processing to resume as soon as the task scheduler 
-        //   can find free time for it. It makes this a busy-wait loop, without
-        //   hogging resources we don't need.
-        std::this_thread::sleep_for(std::chrono::milliseconds(0));
-        end = std::chrono::steady_clock::now();
+
+        if (due) {
+            if (!this->turbo) {
+                this->wait_until(deadline);
+            } // else, do_nothing();
+            deadline += frame;
+            if (std::chrono::steady_clock::now() > deadline + (frame * 4)) {
+                deadline = std::chrono::steady_clock::now() + frame;
+            } // else, do_nothing();
+        } // else, do_nothing();
+        frames++;
+    }
+    this->seconds_run = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return;
+}
+
+/**
+ * Every frame gets instructions_per_second / 60 instructions, and whatever is 
+ *   left over is carried into the next, so that the sum over a second is exact.
+ */
+int tehCHIP::next_frame_cycles() {
+    int owed = this->cycle_remainder + this->instructions_per_second;
+    this->cycle_remainder = owed % 60;
+    return owed / 60;
+}
+
+/**
+ * sleep_until() is only as precise as the scheduler, which can wake us a 
+ *   millisecond or two late. So we sleep until just short of the deadline, and
+ *   yield our way through the rest.
+ */
+void tehCHIP::wait_until(std::chrono::steady_clock::time_point deadline) {
+    const std::chrono::milliseconds spin(2);
+    if (std::chrono::steady_clock::now() < deadline - spin) {
+        std::this_thread::sleep_until(deadline - spin);
+    } // else, do_nothing();
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
     }
     return;
 }
 
+void tehCHIP::set_instructions_per_frame(int count) {
+    if (count > 0) {
+        this->instructions_per_second = count * 60;
+        this->cycle_remainder = 0;
+    } // else do_nothing();
+    return;
+}
+
+void tehCHIP::set_turbo(bool mode) {
+    this->turbo = mode;
+    return;
+}
+
+void tehCHIP::set_limits(unsigned long int frames, 
+                         unsigned long long int cycles) {
+    this->frame_limit = frames;
+    this->cycle_limit = cycles;
+    return;
+}
+
+void tehCHIP::set_idle_skip(bool mode) {
+    this->processor->set_idle_skip(mode);
+    return;
+}
+
+void tehCHIP::report_fusion() {
+    std::cout << "Fused ANNN+DXYN: " 
+              << this->processor->get_fusion_count(tehCPUS::FUSE_LOAD_AND_DRAW)
+              << std::endl;
+    std::cout << "Fused ANNN+FX1E: "
+              << this->processor->get_fusion_count(tehCPUS::FUSE_LOAD_AND_OFFSET)
+              << std::endl;
+    std::cout << "Fused 6XNN+6YNN: "
+              << this->processor->get_fusion_count(tehCPUS::FUSE_LOAD_PAIR)
+              << std::endl;
+    std::cout << "Fused SKIP+1NNN: "
+              << this->processor->get_fusion_count(tehCPUS::FUSE_SKIP_AND_JUMP)
+              << std::endl;
+    return;
+}
+
+void tehCHIP::report_speed() {
+    double mips = 0.0;
+    if (this->seconds_run > 0.0) {
+        mips = (this->instructions_run / this->seconds_run) / 1000000.0;
+    } // else do_nothing();
+    std::cout << "Ran " << this->instructions_run << " instructions in "
+              << this->seconds_run << " seconds: " << mips << " MIPS"
+              << std::endl;
+    return;
+}
+
+void tehCHIP::report_state() {
+    this->processor->report_state();
+    std::cout << "Framebuffer hash: 0x" << std::hex 
+              << this->bus->hash_framebuffer() << std::dec << std::endl;
+    return;
+}
+
+unsigned int tehCHIP::parse_quirk(std::string name) {
+    unsigned int result = 0;
+    if (name == "vfreset") {
+        result = QUIRK_VF_RESET;
+    } else if (name == "shift") {
+        result = QUIRK_SHIFT_VY;
+    } else if (name == "jump") {
+        result = QUIRK_JUMP_VX;
+    } else if (name == "memory") {
+        result = QUIRK_IREG_INCREMENT;
+    } else if (name == "dispwait") {
+        result = QUIRK_DISPLAY_WAIT;
+    } else if (name == "clipping") {
+        result = QUIRK_CLIPPING;
+    } else {
+        std::cout << "Unknown quirk: " << name << std::endl;
+    }
+    return result;
+}
 
 void tehCHIP::reset_system()  {
     this->processor->reset();
@@ -36,6 +36,40 @@ private:
     tehCPUS *processor;
     /** Contains our current quirks mode. */
     systype operating_mode;
+    /** How many instructions we run every second, spread across each frame. */
+    int instructions_per_second;
+    /** 
+     * Instructions owed to the next frame, in sixtieths of an instruction, so
+     *  that rates that don't divide evenly by 60 still come out right.
+     */
+    int cycle_remainder;
+    /** If true, frames run back to back, instead of 60 times a second. */
+    bool turbo;
+    /** How many instructions the last call to execute() ran. */
+    unsigned long long int instructions_run;
+    /** How long the last call to execute() ran for, in seconds. */
+    double seconds_run;
+    /** If nonzero, execute() returns after this many frames. */
+    unsigned long int frame_limit;
+    /** If nonzero, execute() returns after this many instructions. */
+    unsigned long long int cycle_limit;
+
+    /**
+     * @brief Works out how many instructions to run in the next frame.
+     * 
+     * @return The number of instructions to run.
+     */
+    int next_frame_cycles();
+
+    /**
+     * @brief Waits until the given point in time.
+     * 
+     * Most of the wait is spent asleep. Only the last couple of milliseconds
+     *  are spun through, since a sleep can overshoot by about that much.
+     * 
+     * @param deadline The point in time to wait for.
+     */
+    void wait_until(std::chrono::steady_clock::time_point deadline);
 
 public:
     /**
@@ -45,8 +79,11 @@ public:
      * @param b Reference to a speaker object, to be used by the system.
      * @param k Reference to an input object, to be used by the system.
      * @param opMode Sets the quirks and operating mode of the system.
+     * @param c Selects the interpreter, translated blocks, or threaded code.
+     * @param quirks A bitset of chippy::quirk flags, see DEFAULT_QUIRKS().
      */
-    tehCHIP(tehSCREEN& s, tehBEEP& b, tehBOOP& k, systype opMode);
+    tehCHIP(tehSCREEN& s, tehBEEP& b, tehBOOP& k, systype opMode,
+            coretype c, unsigned int quirks);
 
     /**
      * @brief Destructs the Chip-8 interpreter.
@@ -65,6 +102,71 @@ public:
      */
     void execute();
 
+    /**
+     * @brief Sets how many instructions run in each 60Hz frame.
+     * 
+     * The default is 1000 instructions a second, a little under 17 a frame.
+     * 
+     * @param count The number of instructions per frame, at least 1.
+     */
+    void set_instructions_per_frame(int count);
+
+    /**
+     * @brief Toggles turbo mode.
+     * 
+     * In turbo mode, frames run back to back, as fast as the host can manage.
+     *  The timers still count down once every frame's worth of instructions,
+     *  so programs see time passing just as they normally would, only faster.
+     *  The screen, keyboard, and speaker are still only serviced 60 times a 
+     *  second of real time.
+     * 
+     * @param mode If True, run as fast as possible.
+     */
+    void set_turbo(bool mode);
+
+    /**
+     * @brief Makes execute() return once it has run long enough.
+     * 
+     * Without a limit, execute() only returns once we are told to exit. 
+     *  Whichever limit is reached first ends the run.
+     * 
+     * @param frames The most frames to run, or 0 for no limit.
+     * @param cycles The most instructions to run, or 0 for no limit.
+     */
+    void set_limits(unsigned long int frames, unsigned long long int cycles);
+
+    /**
+     * @brief Toggles fast-forwarding through idle loops.
+     * 
+     * @param mode If True, the processor skips loops that can't change state.
+     */
+    void set_idle_skip(bool mode);
+
+    /**
+     * @brief Prints how many times each kind of fused instruction pair ran.
+     */
+    void report_fusion();
+
+    /**
+     * @brief Prints how many instructions the last execute() ran, and how fast.
+     */
+    void report_speed();
+
+    /**
+     * @brief Prints the processor's registers, and a hash of the framebuffer.
+     */
+    void report_state();
+
+    /**
+     * @brief Maps a quirk name onto its chippy::quirk flag.
+     * 
+     * The names are vfreset, shift, jump, memory, dispwait, and clipping.
+     * 
+     * @param name The name of the quirk.
+     * @return The matching flag, or 0 if there isn't one.
+     */
+    static unsigned int parse_quirk(std::string name);
+
     /**
      * @brief This function resets the system.
      * 
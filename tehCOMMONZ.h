@@ -25,21 +25,59 @@
 /**
  * @brief Tests to see if the current quirk mode is in the SUPERCHIP family.
  * 
- * This currently includes SUPERCHIP10, SUPERCHIP11
+ * This currently includes SUPERCHIP10, SUPERCHIP11, and XOCHIP, which builds
+ *  on SUPERCHIP 1.1.
  * 
  * @param a The current quirks mode as a systype enum.
  * @return True if quirk is part of the SUPERCHIP family.
  */
 #define IS_SUPERCHIP(a) \
     ((a == chippy::SUPERCHIP10) \
-    || (a == chippy::SUPERCHIP11)  ? true : false)
+    || (a == chippy::SUPERCHIP11) \
+    || (a == chippy::XOCHIP)  ? true : false)
+
+/**
+ * @brief Returns the quirks a given system is emulated with, by default.
+ * 
+ * CHIP-8 shifts VY, and increments I past the last register in FX55/FX65. The
+ *  CHIP-48 family shifts VX in place, jumps with BXNN, and leaves I one short.
+ *  Both reset VF, wait for the display, and clip sprites. XO-CHIP does none of
+ *  that, except shifting VY, and incrementing I.
+ * 
+ * @param a The current quirks mode as a systype enum.
+ * @return A bitset of chippy::quirk flags.
+ */
+#define DEFAULT_QUIRKS(a) \
+    ((a == chippy::CHIP8) \
+    ? (chippy::QUIRK_VF_RESET | chippy::QUIRK_SHIFT_VY \
+        | chippy::QUIRK_IREG_INCREMENT | chippy::QUIRK_DISPLAY_WAIT \
+        | chippy::QUIRK_CLIPPING) \
+    : (a == chippy::XOCHIP) \
+    ? (chippy::QUIRK_SHIFT_VY | chippy::QUIRK_IREG_INCREMENT) \
+    : (chippy::QUIRK_VF_RESET | chippy::QUIRK_JUMP_VX \
+        | chippy::QUIRK_DISPLAY_WAIT | chippy::QUIRK_CLIPPING))
 
 namespace chippy{ 
     const int DEFAULT_WINDOW_HEIGHT = 256;
     const int DEFAULT_WINDOW_WIDTH = 512;
+    // XO-CHIP has two bitplanes. Everything else has one.
+    const int MAX_PLANES = 2;
     enum systype {
-        CHIP8, CHIP48, SUPERCHIP10, SUPERCHIP11
-    };    
+        CHIP8, CHIP48, SUPERCHIP10, SUPERCHIP11, XOCHIP
+    };
+    // Individual quirks. Any combination of these makes up a quirks profile.
+    enum quirk {
+        QUIRK_VF_RESET = 0x01, // 8XY1, 8XY2, and 8XY3 reset VF to zero.
+        QUIRK_SHIFT_VY = 0x02, // 8XY6, and 8XYE shift VY into VX.
+        QUIRK_JUMP_VX = 0x04, // BNNN jumps to VX + NN, instead of V0 + NNN.
+        QUIRK_IREG_INCREMENT = 0x08, // FX55, and FX65 leave I past the end.
+        QUIRK_DISPLAY_WAIT = 0x10, // DXYN waits for the next display refresh.
+        QUIRK_CLIPPING = 0x20 // Sprites are clipped at the edge of the screen.
+    };
+    // Selects how the processor runs our instructions.
+    enum coretype {
+        INTERPRETER, TRANSLATOR, THREADED
+    };
 }
 
 #endif
\ No newline at end of file
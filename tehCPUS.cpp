@@ -2,13 +2,37 @@
 
 using namespace chippy;
 
-tehCPUS::tehCPUS(tehBUS& bus, systype opMode) {
+tehCPUS::tehCPUS(tehBUS& bus, systype opMode, unsigned int quirks) {
     this->reset();
     this->bus = &bus;
     this->vblank_quirk_block = false;
     this->target = opMode;
+    this->quirks = quirks;
+    this->core = INTERPRETER;
+    this->idle_skip = false;
+    this->fused_skip = false;
+    this->batch_cycles = 0;
+    this->cycle_stamp = 0;
+    for (unsigned int i = 0; i < FUSION_COUNT; i++) {
+        this->fusion_counts[i] = 0;
+    }
     this->dist.param(
         std::uniform_int_distribution<unsigned char>::param_type(0x0, 0xF));
+    this->decode_table = new instruction[DECODE_TABLE_SIZE];
+    this->build_decode_table();
+    this->flush_instruction_cache();
+    for (unsigned int i = 0; i < INSTRUCTION_CACHE_SIZE; i++) {
+        this->block_table[i] = NULL;
+        this->block_coverage[i] = 0;
+    }
+    this->bus->attach_snoop(*this);
+}
+
+tehCPUS::~tehCPUS() {
+    delete[] this->decode_table;
+    for (unsigned int i = 0; i < INSTRUCTION_CACHE_SIZE; i++) {
+        delete this->block_table[i];
+    }
 }
 
 /* on bitN():
@@ -62,19 +86,18 @@ std::string tehCPUS::build_unknown_instruction_error(unsigned short int inst) {
 
 /**
  * For each cycle, we want to first, fetch the instruction from memory at the
- *   location pointed to by the Program Counter (this->PC). This involves two
- *   reads for the upper half of the instruction, and the lower half of the ins-
- *   truction. Then, we call decode_and_execute, the meat of our interpreter.
- *   After executing, we increment the Program Counter- All jump instructions
- *   take into account this increment, and decrement the PC, effectively holding
- *   it in place for one cycle.
+ *   location pointed to by the Program Counter (this->PC). Unless it has
+ *   already been cached, this involves two reads for the upper half of the
+ *   instruction, and the lower half of the instruction. Then, we look the
+ *   instruction up in our decode table, and execute it, the meat of our
+ *   interpreter. After executing, we increment the Program Counter- All jump
+ *   instructions take into account this increment, and decrement the PC,
+ *   effectively holding it in place for one cycle.
  */
 
 void tehCPUS::clock_sys() {
     if (!this->vblank_quirk_block) {
-        short int instruction = this->bus->read_ram(this->PC);
-        instruction = (instruction << 8) + this->bus->read_ram(this->PC + 1);
-        this->decode_and_execute(instruction);
+        this->execute(*this->fetch());
         if (!this->haltPC) {
             this->PC += 2;
         } // else, do not iterate PC
@@ -82,6 +105,829 @@ void tehCPUS::clock_sys() {
     return;
 }
 
+void tehCPUS::set_core(coretype c) {
+    this->core = c;
+    return;
+}
+
+void tehCPUS::set_idle_skip(bool mode) {
+    this->idle_skip = mode;
+    return;
+}
+
+unsigned long int tehCPUS::get_fusion_count(fusion f) {
+    return this->fusion_counts[f];
+}
+
+int tehCPUS::run(int cycles) {
+    int result = 0;
+    this->batch_cycles = cycles;
+    if (this->idle_skip) {
+        result = this->run_skipping_idle(cycles);
+    } else {
+        switch (this->core) {
+        case TRANSLATOR:
+            result = this->run_translated(cycles);
+            break;
+        case THREADED:
+            result = this->run_threaded(cycles);
+            break;
+        default:
+            result = this->run_interpreted(cycles);
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * All of the run_*() loops stop early for the same two reasons. Once the
+ *   display wait starts, nothing runs until clock_60hz(). And FX0A, the only
+ *   instruction that halts, settles once it has run twice in a row: until the
+ *   bus polls the keyboard again, running it any more changes nothing at all.
+ * 
+ * An exit can only be signalled while the bus is being clocked, which happens
+ *   between batches, so that is left to the caller.
+ */
+
+int tehCPUS::run_interpreted(int cycles) {
+    int count = 0;
+    bool halted = false;
+    while (count < cycles && !this->vblank_quirk_block) {
+        this->cycle_stamp = count;
+        this->execute(*this->fetch());
+        count++;
+        if (!this->haltPC) {
+            this->PC += 2;
+        } else if (halted) {
+            break;
+        } // else, do not iterate PC
+        halted = this->haltPC;
+    }
+    return count;
+}
+
+/**
+ * Keys are only polled between batches, and the timers only tick between them,
+ *   so during a batch, the only way a loop of idle-safe instructions can change
+ *   its own behaviour is through the registers it changes. If a backwards jump
+ *   lands us on the same address, with the same registers, as the last one did,
+ *   then every iteration from here on will be identical, until the batch ends.
+ *   We skip as many whole iterations as fit into the batch, and run the rest,
+ *   so the processor ends the batch in exactly the state it would have anyway.
+ * 
+ * This catches both FX07 / 3X00 / 1NNN waits on the delay timer, and 1NNN
+ *   jumps to themselves.
+ */
+
+int tehCPUS::run_skipping_idle(int cycles) {
+    int count = 0;
+    bool halted = false;
+    // What we saw at the last backwards jump, if it has been idle-safe since.
+    bool watching = false;
+    unsigned short int loop_start = 0;
+    unsigned short int loop_I = 0;
+    unsigned char loop_regs[16];
+    int loop_count = 0;
+    while (count < cycles && !this->vblank_quirk_block) {
+        const instruction* inst = this->fetch();
+        unsigned short int address = this->PC;
+        this->cycle_stamp = count;
+        this->execute(*inst);
+        count++;
+        if (!this->haltPC) {
+            this->PC += 2;
+        } else if (halted) {
+            break;
+        } // else, do not iterate PC
+        halted = this->haltPC;
+
+        if (!this->is_idle_safe(inst->op)) {
+            watching = false;
+        } else if (inst->op == OP_1NNN_JMP && inst->NNN <= address) {
+            if (watching && loop_start == this->PC && loop_I == this->Ireg
+                && std::memcmp(loop_regs, this->regFile, 16) == 0) {
+                int length = count - loop_count;
+                count += ((cycles - count) / length) * length;
+            } // else, do_nothing();
+            watching = true;
+            loop_start = this->PC;
+            loop_I = this->Ireg;
+            std::memcpy(loop_regs, this->regFile, 16);
+            loop_count = count;
+        } // else, do_nothing();
+    }
+    return count;
+}
+
+/**
+ * Addresses past the end of the cache can still be executed from, they just
+ *   aren't cached, and have to be read from RAM every time.
+ */
+
+const tehCPUS::instruction* tehCPUS::fetch() {
+    const instruction* result = NULL;
+    if (this->PC < INSTRUCTION_CACHE_SIZE) {
+        result = this->instruction_cache[this->PC];
+    } // else, do_nothing();
+    if (result == NULL) {
+        unsigned short int inst = (this->bus->read_ram(this->PC) << 8)
+                                | this->bus->read_ram(this->PC + 1);
+        result = &this->decode_table[inst];
+        if (this->PC < INSTRUCTION_CACHE_SIZE) {
+            this->instruction_cache[this->PC] = result;
+        } // else, do_nothing();
+    } // else, cache hit.
+    return result;
+}
+
+/**
+ * Only a taken skip ever calls this, so the extra read costs nothing on every
+ *   other instruction.
+ */
+
+unsigned short int tehCPUS::skip_length(unsigned short int addr) {
+    unsigned short int result = 2;
+    if (this->target == chippy::XOCHIP
+        && this->bus->read_ram((unsigned short int) (addr + 2)) == 0xF0
+        && this->bus->read_ram((unsigned short int) (addr + 3)) == 0x00) {
+        result = 4;
+    } // else, do_nothing();
+    return result;
+}
+
+int tehCPUS::scroll_scale() {
+    int result = 1;
+    if (this->target == chippy::XOCHIP && this->bus->get_video_mode()) {
+        result = 2;
+    } // else, do_nothing();
+    return result;
+}
+
+void tehCPUS::flush_instruction_cache() {
+    for (unsigned int i = 0; i < INSTRUCTION_CACHE_SIZE; i++) {
+        this->instruction_cache[i] = NULL;
+    }
+    return;
+}
+
+/**
+ * A write to addr changes the instruction starting at addr, and the one 
+ *   starting at the byte before it. Nothing else needs to be thrown away, other
+ *   than any translated blocks built from that byte.
+ */
+
+void tehCPUS::snoop_write(int addr) {
+    if (addr >= 0 && addr < (int) INSTRUCTION_CACHE_SIZE) {
+        this->instruction_cache[addr] = NULL;
+        if (this->block_coverage[addr] > 0) {
+            this->invalidate_blocks(addr);
+        } // else, do_nothing();
+    } // else, do_nothing();
+    if (addr >= 1 && addr <= (int) INSTRUCTION_CACHE_SIZE) {
+        this->instruction_cache[addr - 1] = NULL;
+    } // else, do_nothing();
+    return;
+}
+
+/**
+ * Translated blocks run exactly the same handlers as clock_sys() does, in
+ *   exactly the same order. What we save is the per-instruction bookkeeping:
+ *   a block can only be stopped by its last instruction, so the fetch, and the
+ *   checks for halting and the display wait only happen once per block. 
+ * 
+ * When a block runs to its end, we remember which block ran next. Most of the 
+ *   time, it's the same block again, and we can chain straight to it without 
+ *   looking it up.
+ * 
+ * Blocks only ever run whole. If there aren't enough cycles left in the batch
+ *   for the next one, we finish the batch one cycle at a time.
+ */
+
+int tehCPUS::run_translated(int cycles) {
+    int count = 0;
+    bool halted = false;
+    block* previous = NULL;
+    while (count < cycles && !this->vblank_quirk_block) {
+        block* current = NULL;
+        if (!this->haltPC && this->PC < INSTRUCTION_CACHE_SIZE - 1) {
+            if (previous != NULL && previous->link != NULL
+                && previous->link->valid && previous->link->start == this->PC) {
+                current = previous->link;
+            } else {
+                current = this->find_block();
+                if (previous != NULL) {
+                    previous->link = current;
+                } // else, do_nothing();
+            }
+            if (current->length > cycles - count) {
+                current = NULL;
+            } // else, do_nothing();
+        } // else, do_nothing();
+
+        if (current == NULL) {
+            // Halted, running off the end of RAM, or running out of cycles.
+            //   Step one cycle at a time.
+            this->cycle_stamp = count;
+            this->clock_sys();
+            count++;
+            previous = NULL;
+            if (this->haltPC && halted) {
+                break;
+            } // else, do_nothing();
+        } else {
+            int last = current->entries - 1;
+            for (int i = 0; i < last; i++) {
+                this->execute(current->code[i]);
+                this->PC += 2;
+            }
+            // Only the final instruction is allowed to halt the processor, or
+            //   to change the sound timer.
+            this->cycle_stamp = count + current->length - 1;
+            this->execute(current->code[last]);
+            if (!this->haltPC) {
+                this->PC += 2;
+            } // else, do not iterate PC
+            count += current->length;
+            if (this->fused_skip) {
+                count--;
+                this->fused_skip = false;
+            } // else, do_nothing();
+            previous = current;
+        }
+        halted = this->haltPC;
+    }
+    return count;
+}
+
+/*
+ * The threaded loop keeps the machine state in locals for the whole batch, and
+ *   each operation jumps straight to the next one, rather than returning to a
+ *   central switch. Computed goto is a GCC/Clang extension, so everywhere else,
+ *   or if CHIPPY_NO_COMPUTED_GOTO is defined, we dispatch through a switch.
+ */
+
+#if defined(__GNUC__) && !defined(CHIPPY_NO_COMPUTED_GOTO)
+#define CHIPPY_COMPUTED_GOTO
+#endif
+
+// Labels can be fallen into freely, but switch cases have to say so.
+#ifdef CHIPPY_COMPUTED_GOTO
+#define OPERATION(op) L_##op
+#define SLOW_OPERATION L_SLOW
+#define DISPATCH() goto *labels[inst->op]
+#define FALLTHROUGH()
+#else
+#define OPERATION(op) case op
+#define SLOW_OPERATION default
+#define DISPATCH() goto dispatch
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define FALLTHROUGH() __attribute__((fallthrough))
+#else
+#define FALLTHROUGH()
+#endif
+#endif
+
+// Fetch from the instruction cache, falling back to fetch() on a miss.
+#define FETCH() \
+    if (pc >= INSTRUCTION_CACHE_SIZE || (inst = cache[pc]) == NULL) { \
+        this->PC = pc; \
+        inst = this->fetch(); \
+    }
+
+// Advance to, and jump to the next instruction, unless we're out of cycles.
+#define NEXT() \
+    pc += 2; \
+    if (--cycles <= 0) { \
+        goto done; \
+    } \
+    FETCH(); \
+    DISPATCH();
+
+/**
+ * Only the simple, register-only operations are handled inline. Everything
+ *   else takes the slow path, where we write our locals back, run the regular
+ *   handler, and read them back in again. Since the handler sees the same state
+ *   clock_sys() would have given it, this includes anything that throws, halts,
+ *   touches memory, or talks to a peripheral.
+ */
+
+int tehCPUS::run_threaded(int cycles) {
+#ifdef CHIPPY_COMPUTED_GOTO
+    // Must match the order of the operation enum.
+    static const void* const labels[OP_COUNT] = {
+        &&L_SLOW,                           // OP_UNKNOWN
+        &&L_OP_0NNN_SYS,
+        &&L_SLOW,                           // OP_00CN_SCROLL_DOWN
+        &&L_SLOW,                           // OP_00E0_CLS
+        &&L_SLOW,                           // OP_00EE_RET
+        &&L_SLOW,                           // OP_00FB_SCROLL_RIGHT
+        &&L_SLOW,                           // OP_00FC_SCROLL_LEFT
+        &&L_SLOW,                           // OP_00FE_DISABLE_HIRES
+        &&L_SLOW,                           // OP_00FF_ENABLE_HIRES
+        &&L_OP_1NNN_JMP,
+        &&L_SLOW,                           // OP_2NNN_CALL
+        &&L_OP_3XNN_SKIP_IF_EQUAL,
+        &&L_OP_4XNN_SKIP_IF_NOT_EQUAL,
+        &&L_OP_5XY0_SKIP_IF_X_EQ_Y,
+        &&L_SLOW,                           // OP_5XY2_SAVE_RANGE
+        &&L_SLOW,                           // OP_5XY3_LOAD_RANGE
+        &&L_OP_6XNN_LOAD_NN_TO_X,
+        &&L_OP_7XNN_ADD_NN_TO_X,
+        &&L_OP_8XY0_COPY_X_TO_Y,
+        &&L_OP_8XY1_OR_X_WITH_Y,
+        &&L_OP_8XY1_OR_X_WITH_Y_KEEP_VF,
+        &&L_OP_8XY2_AND_X_WITH_Y,
+        &&L_OP_8XY2_AND_X_WITH_Y_KEEP_VF,
+        &&L_OP_8XY3_XOR_X_WITH_Y,
+        &&L_OP_8XY3_XOR_X_WITH_Y_KEEP_VF,
+        &&L_OP_8XY4_ADD_X_AND_Y,
+        &&L_OP_8XY5_SUB_Y_FROM_X,
+        &&L_OP_8XZ6_SHIFT_X_RIGHT,
+        &&L_OP_8XY6_SHIFT_Y_RIGHT,
+        &&L_OP_8XY7_SUB_X_FROM_Y,
+        &&L_OP_8XZE_SHIFT_X_LEFT,
+        &&L_OP_8XYE_SHIFT_Y_LEFT,
+        &&L_OP_9XY0_SKIP_IF_X_NE_Y,
+        &&L_OP_ANNN_LOAD_IREG,
+        &&L_OP_BNNN_JUMP_TO_OFFSET,
+        &&L_OP_BXNN_JUMP_TO_OFFSET,
+        &&L_SLOW,                           // OP_CXNN_RANDOM
+        &&L_SLOW,                           // OP_DXYN_DRAW
+        &&L_SLOW,                           // OP_DXYN_DRAW_NO_WAIT
+        &&L_SLOW,                           // OP_EX9E_SKIP_IF_KEY
+        &&L_SLOW,                           // OP_EXA1_SKIP_IF_NO_KEY
+        &&L_SLOW,                           // OP_F000_LOAD_LONG_IREG
+        &&L_OP_FX07_READ_DISPLAY_TIMER,
+        &&L_SLOW,                           // OP_FX0A_READ_KEY
+        &&L_OP_FX15_SET_DISPLAY_TIMER,
+        &&L_OP_FX18_SET_SOUND_TIMER,
+        &&L_OP_FX1E_ADD_VX_TO_I,
+        &&L_OP_FX29_LOAD_HEX_SPRITE,
+        &&L_SLOW,                           // OP_FX33_SAVE_BCD_VALUE
+        &&L_SLOW,                           // OP_FX55_SAVE_REGISTERS
+        &&L_SLOW,                           // OP_FX55_SAVE_REGISTERS_HP48
+        &&L_SLOW,                           // OP_FX65_LOAD_REGISTERS
+        &&L_SLOW,                           // OP_FX65_LOAD_REGISTERS_HP48
+        &&L_SLOW,                           // OP_FN01_SELECT_PLANES
+        // Fused pairs never reach us, but they'd be safe on the slow path.
+        &&L_SLOW,                           // OP_ANNN_DXYN_LOAD_AND_DRAW
+        &&L_SLOW,                           // OP_ANNN_DXYN_LOAD_AND_DRAW_NO_WAIT
+        &&L_SLOW,                           // OP_ANNN_FX1E_LOAD_AND_OFFSET
+        &&L_SLOW,                           // OP_6XNN_6YNN_LOAD_PAIR
+        &&L_SLOW,                           // OP_3XNN_1NNN_JUMP_IF_NOT_EQUAL
+        &&L_SLOW                            // OP_4XNN_1NNN_JUMP_IF_EQUAL
+    };
+#endif
+
+    if (cycles <= 0 || this->vblank_quirk_block) {
+        return 0;
+    } // else, do_nothing();
+
+    const int requested = cycles;
+    bool halted = false;
+    const instruction* const* cache = this->instruction_cache;
+    const instruction* inst = NULL;
+    unsigned short int pc = this->PC;
+    unsigned short int I = this->Ireg;
+    unsigned char DT = this->DTreg;
+    unsigned char ST = this->STreg;
+    unsigned char V[16];
+    std::memcpy(V, this->regFile, sizeof(V));
+
+    FETCH();
+    DISPATCH();
+
+#ifndef CHIPPY_COMPUTED_GOTO
+dispatch:
+    switch (inst->op) {
+#endif
+
+OPERATION(OP_0NNN_SYS):
+    NEXT();
+
+OPERATION(OP_1NNN_JMP):
+    pc = inst->NNN - 2;
+    NEXT();
+
+OPERATION(OP_3XNN_SKIP_IF_EQUAL):
+    if (V[inst->X] == inst->NN) {
+        pc += this->skip_length(pc);
+    } // else do_nothing();
+    NEXT();
+
+OPERATION(OP_4XNN_SKIP_IF_NOT_EQUAL):
+    if (V[inst->X] != inst->NN) {
+        pc += this->skip_length(pc);
+    } // else do_nothing();
+    NEXT();
+
+OPERATION(OP_5XY0_SKIP_IF_X_EQ_Y):
+    if (V[inst->X] == V[inst->Y]) {
+        pc += this->skip_length(pc);
+    } // else do_nothing();
+    NEXT();
+
+OPERATION(OP_6XNN_LOAD_NN_TO_X):
+    V[inst->X] = inst->NN;
+    NEXT();
+
+OPERATION(OP_7XNN_ADD_NN_TO_X):
+    V[inst->X] = V[inst->X] + inst->NN;
+    NEXT();
+
+OPERATION(OP_8XY0_COPY_X_TO_Y):
+    V[inst->X] = V[inst->Y];
+    NEXT();
+
+OPERATION(OP_8XY1_OR_X_WITH_Y):
+    V[inst->X] |= V[inst->Y];
+    V[0xF] = 0;
+    NEXT();
+
+OPERATION(OP_8XY1_OR_X_WITH_Y_KEEP_VF):
+    V[inst->X] |= V[inst->Y];
+    NEXT();
+
+OPERATION(OP_8XY2_AND_X_WITH_Y):
+    V[inst->X] &= V[inst->Y];
+    V[0xF] = 0;
+    NEXT();
+
+OPERATION(OP_8XY2_AND_X_WITH_Y_KEEP_VF):
+    V[inst->X] &= V[inst->Y];
+    NEXT();
+
+OPERATION(OP_8XY3_XOR_X_WITH_Y):
+    V[inst->X] ^= V[inst->Y];
+    V[0xF] = 0;
+    NEXT();
+
+OPERATION(OP_8XY3_XOR_X_WITH_Y_KEEP_VF):
+    V[inst->X] ^= V[inst->Y];
+    NEXT();
+
+OPERATION(OP_8XY4_ADD_X_AND_Y):
+    {
+        unsigned short int temp = V[inst->X] + V[inst->Y];
+        V[inst->X] = (unsigned char) temp;
+        V[0xF] = (temp > 0xFF) ? 1 : 0;
+    }
+    NEXT();
+
+OPERATION(OP_8XY5_SUB_Y_FROM_X):
+    {
+        unsigned char borrow = (V[inst->X] < V[inst->Y]) ? 0 : 1;
+        V[inst->X] = V[inst->X] - V[inst->Y];
+        V[0xF] = borrow;
+    }
+    NEXT();
+
+OPERATION(OP_8XY6_SHIFT_Y_RIGHT):
+    V[inst->X] = V[inst->Y];
+    // Fall through, and shift the copy.
+    FALLTHROUGH();
+OPERATION(OP_8XZ6_SHIFT_X_RIGHT):
+    {
+        unsigned char LSB = V[inst->X] & 0x1;
+        V[inst->X] >>= 1;
+        V[0xF] = LSB;
+    }
+    NEXT();
+
+OPERATION(OP_8XY7_SUB_X_FROM_Y):
+    {
+        unsigned char borrow = (V[inst->Y] < V[inst->X]) ? 0 : 1;
+        V[inst->X] = V[inst->Y] - V[inst->X];
+        V[0xF] = borrow;
+    }
+    NEXT();
+
+OPERATION(OP_8XYE_SHIFT_Y_LEFT):
+    V[inst->X] = V[inst->Y];
+    // Fall through, and shift the copy.
+    FALLTHROUGH();
+OPERATION(OP_8XZE_SHIFT_X_LEFT):
+    {
+        unsigned char MSB = (V[inst->X] & 0x80) >> 7;
+        V[inst->X] <<= 1;
+        V[0xF] = MSB;
+    }
+    NEXT();
+
+OPERATION(OP_9XY0_SKIP_IF_X_NE_Y):
+    if (V[inst->X] != V[inst->Y]) {
+        pc += this->skip_length(pc);
+    } // else do_nothing();
+    NEXT();
+
+OPERATION(OP_ANNN_LOAD_IREG):
+    I = inst->NNN;
+    NEXT();
+
+OPERATION(OP_BNNN_JUMP_TO_OFFSET):
+    pc = V[0x0] + inst->NNN - 2;
+    NEXT();
+
+OPERATION(OP_BXNN_JUMP_TO_OFFSET):
+    pc = V[inst->X] + inst->NN - 2;
+    NEXT();
+
+OPERATION(OP_FX07_READ_DISPLAY_TIMER):
+    V[inst->X] = DT;
+    NEXT();
+
+OPERATION(OP_FX15_SET_DISPLAY_TIMER):
+    DT = V[inst->X];
+    NEXT();
+
+OPERATION(OP_FX18_SET_SOUND_TIMER):
+    ST = V[inst->X];
+    this->sound_edge(ST > 0, requested - cycles);
+    NEXT();
+
+OPERATION(OP_FX1E_ADD_VX_TO_I):
+    I = I + V[inst->X];
+    NEXT();
+
+OPERATION(OP_FX29_LOAD_HEX_SPRITE):
+    I = V[inst->X] * 5;
+    NEXT();
+
+SLOW_OPERATION:
+    this->PC = pc;
+    this->Ireg = I;
+    this->DTreg = DT;
+    this->STreg = ST;
+    std::memcpy(this->regFile, V, sizeof(V));
+    this->cycle_stamp = requested - cycles;
+    this->execute(*inst);
+    pc = this->PC;
+    I = this->Ireg;
+    DT = this->DTreg;
+    ST = this->STreg;
+    std::memcpy(V, this->regFile, sizeof(V));
+    if (this->haltPC) {
+        if (halted) {
+            // Still waiting on a key, so there's nothing more to do.
+            cycles--;
+            goto done;
+        } // else, do_nothing();
+        // Hold the PC in place, and run the same instruction again.
+        pc -= 2;
+    } // else, do_nothing();
+    halted = this->haltPC;
+    if (this->vblank_quirk_block) {
+        // The rest of the batch is spent waiting on the display.
+        pc += 2;
+        cycles--;
+        goto done;
+    } // else, do_nothing();
+    NEXT();
+
+#ifndef CHIPPY_COMPUTED_GOTO
+    }
+#endif
+
+done:
+    this->PC = pc;
+    this->Ireg = I;
+    this->DTreg = DT;
+    this->STreg = ST;
+    std::memcpy(this->regFile, V, sizeof(V));
+    return requested - cycles;
+}
+
+#undef NEXT
+#undef FETCH
+#undef DISPATCH
+#undef FALLTHROUGH
+#undef SLOW_OPERATION
+#undef OPERATION
+
+tehCPUS::block* tehCPUS::find_block() {
+    block* result = this->block_table[this->PC];
+    if (result == NULL) {
+        result = new block;
+        result->valid = false;
+        this->block_table[this->PC] = result;
+    } // else, do_nothing();
+    if (!result->valid) {
+        this->translate_block(result, this->PC);
+    } // else, do_nothing();
+    return result;
+}
+
+/**
+ * Translation stops after the first instruction that could jump, skip, wait,
+ *   write to memory, or set the sound timer, after MAX_BLOCK_LENGTH
+ *   instructions, or at the end of RAM. The sound timer is on that list so
+ *   that the speaker can be told exactly which cycle it changed on. Every byte
+ *   the block was read from is marked as covered, so that a write to it can
+ *   find, and invalidate, the block.
+ */
+
+void tehCPUS::translate_block(block* b, unsigned short int addr) {
+    b->start = addr;
+    b->length = 0;
+    b->entries = 0;
+    b->link = NULL;
+    bool done = false;
+    while (!done) {
+        unsigned short int inst = (this->bus->read_ram(addr) << 8)
+                                | this->bus->read_ram(addr + 1);
+        instruction& current = b->code[b->entries];
+        current = this->decode_table[inst];
+        int size = 1;
+        if (b->length + 2u <= MAX_BLOCK_LENGTH 
+            && addr + 3u < INSTRUCTION_CACHE_SIZE) {
+            unsigned short int next = (this->bus->read_ram(addr + 2) << 8)
+                                    | this->bus->read_ram(addr + 3);
+            if (this->fuse_instructions(current, this->decode_table[next])) {
+                size = 2;
+            } // else, do_nothing();
+        } // else, do_nothing();
+        for (int i = 0; i < size * 2; i++) {
+            this->block_coverage[addr++]++;
+        }
+        b->length += size;
+        b->entries++;
+        done = this->ends_block(current.op)
+            || b->length >= MAX_BLOCK_LENGTH
+            || addr >= INSTRUCTION_CACHE_SIZE - 1;
+    }
+    b->valid = true;
+    return;
+}
+
+/**
+ * A block can only be as long as MAX_BLOCK_LENGTH instructions, so only blocks
+ *   starting shortly before the written address could have been built from it.
+ */
+
+void tehCPUS::invalidate_blocks(int addr) {
+    int first = addr - (int) (MAX_BLOCK_LENGTH * 2) + 1;
+    if (first < 0) {
+        first = 0;
+    } // else, do_nothing();
+    for (int i = first; i <= addr; i++) {
+        block* b = this->block_table[i];
+        if (b != NULL && b->valid && addr < b->start + (b->length * 2)) {
+            b->valid = false;
+            for (int j = b->start; j < b->start + (b->length * 2); j++) {
+                this->block_coverage[j]--;
+            }
+        } // else, do_nothing();
+    }
+    return;
+}
+
+/**
+ * The second instruction of a pair still runs at its own address, as far as the
+ *   rest of the processor can tell, so a fault in it looks exactly the same.
+ *   Pairs are only fused when the block has room for both, and the first one
+ *   wouldn't have ended the block on its own, unless the pair is a skip over a
+ *   jump, which ends the block either way.
+ */
+
+bool tehCPUS::fuse_instructions(instruction& first, const instruction& second) {
+    bool result = true;
+    if (first.op == OP_ANNN_LOAD_IREG && second.op == OP_DXYN_DRAW) {
+        first.op = OP_ANNN_DXYN_LOAD_AND_DRAW;
+        first.X = second.X;
+        first.Y = second.Y;
+        first.N = second.N;
+    } else if (first.op == OP_ANNN_LOAD_IREG 
+               && second.op == OP_DXYN_DRAW_NO_WAIT) {
+        first.op = OP_ANNN_DXYN_LOAD_AND_DRAW_NO_WAIT;
+        first.X = second.X;
+        first.Y = second.Y;
+        first.N = second.N;
+    } else if (first.op == OP_ANNN_LOAD_IREG 
+               && second.op == OP_FX1E_ADD_VX_TO_I) {
+        first.op = OP_ANNN_FX1E_LOAD_AND_OFFSET;
+        first.X = second.X;
+    } else if (first.op == OP_6XNN_LOAD_NN_TO_X 
+               && second.op == OP_6XNN_LOAD_NN_TO_X) {
+        first.op = OP_6XNN_6YNN_LOAD_PAIR;
+        first.Y = second.X;
+        first.N = second.NN;
+    } else if (first.op == OP_3XNN_SKIP_IF_EQUAL 
+               && second.op == OP_1NNN_JMP) {
+        first.op = OP_3XNN_1NNN_JUMP_IF_NOT_EQUAL;
+        first.NNN = second.NNN;
+    } else if (first.op == OP_4XNN_SKIP_IF_NOT_EQUAL 
+               && second.op == OP_1NNN_JMP) {
+        first.op = OP_4XNN_1NNN_JUMP_IF_EQUAL;
+        first.NNN = second.NNN;
+    } else {
+        result = false;
+    }
+    return result;
+}
+
+bool tehCPUS::is_idle_safe(unsigned char op) {
+    bool result = false;
+    switch (op) {
+    case OP_0NNN_SYS:
+    case OP_1NNN_JMP:
+    case OP_3XNN_SKIP_IF_EQUAL:
+    case OP_4XNN_SKIP_IF_NOT_EQUAL:
+    case OP_5XY0_SKIP_IF_X_EQ_Y:
+    case OP_6XNN_LOAD_NN_TO_X:
+    case OP_7XNN_ADD_NN_TO_X:
+    case OP_8XY0_COPY_X_TO_Y:
+    case OP_8XY1_OR_X_WITH_Y:
+    case OP_8XY1_OR_X_WITH_Y_KEEP_VF:
+    case OP_8XY2_AND_X_WITH_Y:
+    case OP_8XY2_AND_X_WITH_Y_KEEP_VF:
+    case OP_8XY3_XOR_X_WITH_Y:
+    case OP_8XY3_XOR_X_WITH_Y_KEEP_VF:
+    case OP_8XY4_ADD_X_AND_Y:
+    case OP_8XY5_SUB_Y_FROM_X:
+    case OP_8XZ6_SHIFT_X_RIGHT:
+    case OP_8XY6_SHIFT_Y_RIGHT:
+    case OP_8XY7_SUB_X_FROM_Y:
+    case OP_8XZE_SHIFT_X_LEFT:
+    case OP_8XYE_SHIFT_Y_LEFT:
+    case OP_9XY0_SKIP_IF_X_NE_Y:
+    case OP_ANNN_LOAD_IREG:
+    case OP_BNNN_JUMP_TO_OFFSET:
+    case OP_BXNN_JUMP_TO_OFFSET:
+    case OP_EX9E_SKIP_IF_KEY:
+    case OP_EXA1_SKIP_IF_NO_KEY:
+    case OP_FX07_READ_DISPLAY_TIMER:
+    case OP_FX1E_ADD_VX_TO_I:
+    case OP_FX29_LOAD_HEX_SPRITE:
+    case OP_FX65_LOAD_REGISTERS:
+    case OP_FX65_LOAD_REGISTERS_HP48:
+    case OP_5XY3_LOAD_RANGE:
+        result = true;
+        break;
+    default:
+        result = false;
+        break;
+    }
+    return result;
+}
+
+bool tehCPUS::ends_block(unsigned char op) {
+    bool result = false;
+    switch (op) {
+    case OP_00EE_RET:
+    case OP_1NNN_JMP:
+    case OP_2NNN_CALL:
+    case OP_3XNN_SKIP_IF_EQUAL:
+    case OP_4XNN_SKIP_IF_NOT_EQUAL:
+    case OP_5XY0_SKIP_IF_X_EQ_Y:
+    case OP_9XY0_SKIP_IF_X_NE_Y:
+    case OP_BNNN_JUMP_TO_OFFSET:
+    case OP_BXNN_JUMP_TO_OFFSET:
+    case OP_DXYN_DRAW:
+    case OP_DXYN_DRAW_NO_WAIT:
+    case OP_EX9E_SKIP_IF_KEY:
+    case OP_EXA1_SKIP_IF_NO_KEY:
+    case OP_FX0A_READ_KEY:
+    case OP_FX18_SET_SOUND_TIMER:
+    case OP_FX33_SAVE_BCD_VALUE:
+    case OP_FX55_SAVE_REGISTERS:
+    case OP_FX55_SAVE_REGISTERS_HP48:
+    case OP_5XY2_SAVE_RANGE:
+    case OP_F000_LOAD_LONG_IREG:
+    case OP_ANNN_DXYN_LOAD_AND_DRAW:
+    case OP_ANNN_DXYN_LOAD_AND_DRAW_NO_WAIT:
+    case OP_3XNN_1NNN_JUMP_IF_NOT_EQUAL:
+    case OP_4XNN_1NNN_JUMP_IF_EQUAL:
+        result = true;
+        break;
+    default:
+        result = false;
+        break;
+    }
+    return result;
+}
+
+/**
+ * Everything is printed in hex, reusing get_hex_instruction(), and the byte
+ *   wide registers just keep its last two digits.
+ */
+
+void tehCPUS::report_state() {
+    std::cout << "PC: 0x" << this->get_hex_instruction(this->PC)
+              << " I: 0x" << this->get_hex_instruction(this->Ireg)
+              << " SP: 0x" << this->get_hex_instruction(this->SPreg).substr(2)
+              << " DT: 0x" << this->get_hex_instruction(this->DTreg).substr(2)
+              << " ST: 0x" << this->get_hex_instruction(this->STreg).substr(2)
+              << std::endl;
+    for (int i = 0; i < 16; i++) {
+        std::cout << "V" << this->get_hex_instruction(i).substr(3) << ": 0x"
+                  << this->get_hex_instruction(this->regFile[i]).substr(2)
+                  << (((i % 8) == 7) ? "\n" : " ");
+    }
+    std::cout << std::flush;
+    return;
+}
+
 /**
  * These registers reduce, and are clocked, at a rate of 60 Hz. No operation is 
  *   performed if they're currently zero.
@@ -98,12 +944,24 @@ void tehCPUS::clock_60hz() {
     return;
 }
 
-// This functionality is a little awkward. I should rewrite the sound buffer to
-// generate samples more granularly.
+// The speaker keeps time by this, so it's called once a frame, whether the
+// tone is playing or not.
 void tehCPUS::set_sound() {
-    if (this->STreg > 0) {
-        this->bus->screm();
-    } // else do_nothing()
+    this->sounding = (this->STreg > 0);
+    this->bus->screm(this->sounding);
+    return;
+}
+
+/**
+ * Only FX18, and FX0A's beep, can start the tone, or stop it early, so only
+ *   they call this. The timer running out always happens at the end of a frame,
+ *   and is left to set_sound().
+ */
+void tehCPUS::sound_edge(bool on, int cycle) {
+    if (on != this->sounding) {
+        this->sounding = on;
+        this->bus->screm(on, cycle, this->batch_cycles);
+    } // else, do_nothing();
     return;
 }
 
@@ -117,6 +975,7 @@ void tehCPUS::reset() {
     this->Ireg = 0;
     this->DTreg = 0;
     this->STreg = 0;
+    this->sounding = false;
     this->haltPC = false;
     for (int i = 0; i < 16 ; i++) {
         this->regFile[i] = 0;
@@ -132,66 +991,96 @@ void tehCPUS::reset() {
  *   tions to this, however, where other identifying bits must be used. For
  *   these instructions, we will call a function that will decode that 
  *   particular subset of instructions.
+ *
+ * Every operand field is extracted here, once, so that the handlers never have
+ *   to pick the instruction apart themselves.
  */
 
-void tehCPUS::decode_and_execute(unsigned short int inst) {
+tehCPUS::instruction tehCPUS::decode(unsigned short int inst) {
+    instruction result;
+    result.op = OP_UNKNOWN;
+    result.X = this->bitN(inst, 2);
+    result.Y = this->bitN(inst, 1);
+    result.N = this->bitN(inst, 0);
+    result.NN = this->bitsNN(inst);
+    result.NNN = this->bitsNNN(inst);
+    result.raw = inst;
+
     switch (this->bitN(inst, 3)) {
     case 0x0: // Control OPs - CLS, RET
-        this->decode_hex_0(inst);
+        result.op = this->decode_hex_0(inst);
         break;
     case 0x1: // JP to 0xNNN
-        this->I_1NNN_JMP(inst);
+        result.op = OP_1NNN_JMP;
         break;
     case 0x2: // CALL 0xNNN
-        this->I_2NNN_CALL(inst);
+        result.op = OP_2NNN_CALL;
         break;
     case 0x3: // SE 
-        this->I_3XNN_SKIP_IF_EQUAL(inst);
+        result.op = OP_3XNN_SKIP_IF_EQUAL;
         break;
     case 0x4: // SNE
-        this->I_4XNN_SKIP_IF_NOT_EQUAL(inst);
+        result.op = OP_4XNN_SKIP_IF_NOT_EQUAL;
         break;
     case 0x5: // SRE
-        this->I_5XY0_SKIP_IF_X_EQ_Y(inst);
+        // XO-CHIP saves, and loads, ranges of registers with 5XY2, and 5XY3.
+        if (this->target == chippy::XOCHIP && result.N == 0x2) {
+            result.op = OP_5XY2_SAVE_RANGE;
+        } else if (this->target == chippy::XOCHIP && result.N == 0x3) {
+            result.op = OP_5XY3_LOAD_RANGE;
+        } else {
+            result.op = OP_5XY0_SKIP_IF_X_EQ_Y;
+        }
         break;
     case 0x6: // LD
-        this->I_6XNN_LOAD_NN_TO_X(inst);
+        result.op = OP_6XNN_LOAD_NN_TO_X;
         break;
     case 0x7: // ADD
-        this->I_7XNN_ADD_NN_TO_X(inst);
+        result.op = OP_7XNN_ADD_NN_TO_X;
         break;
     case 0x8: // Register Ops -
         // (CPR, OR, AND, XOR, ADDR, SUBR, SHR, SUBN, SHL)
-        this->decode_hex_8(inst);
+        result.op = this->decode_hex_8(inst);
         break;
     case 0x9: // SNER
-        this->I_9XY0_SKIP_IF_X_NE_Y(inst);
+        result.op = OP_9XY0_SKIP_IF_X_NE_Y;
         break;
     case 0xA: // LDI
-        this->I_ANNN_LOAD_IREG(inst);
+        result.op = OP_ANNN_LOAD_IREG;
         break;
     case 0xB: // JPR
-        this->I_BNNN_JUMP_TO_OFFSET(inst);
+        if (this->quirks & QUIRK_JUMP_VX) {
+            result.op = OP_BXNN_JUMP_TO_OFFSET;
+        } else {
+            result.op = OP_BNNN_JUMP_TO_OFFSET;
+        }
         break;
     case 0xC: // RND
-        this->I_CXNN_RANDOM(inst);
+        result.op = OP_CXNN_RANDOM;
         break;
     case 0xD: // DRAW
-        this->I_DXYN_DRAW(inst);
+        if (this->quirks & QUIRK_DISPLAY_WAIT) {
+            result.op = OP_DXYN_DRAW;
+        } else {
+            result.op = OP_DXYN_DRAW_NO_WAIT;
+        }
+        // SUPERCHIP 1.0, 1.1, and XO-CHIP, draw a 16x16 sprite for DXY0.
+        if (result.N == 0 && IS_SUPERCHIP(this->target)) {
+            result.N = 16;
+        } // else do_nothing();
         break;
     case 0xE: // Key detection OPs - SKP, SKNP
-        this->decode_hex_E(inst);
+        result.op = this->decode_hex_E(inst);
         break;
     case 0xF: // Extra OPs -
         // (RDDT, LDK, LDDT, LDST, ADDI, LDSV, SAVEB, SAVEN, LOADN)
-        this->decode_hex_F(inst);
+        result.op = this->decode_hex_F(inst);
         break;
     default:
-        // throw std::out_of_range(build_unknown_instruction_error(inst).c_str());
-        std::cout << build_unknown_instruction_error(inst) << std::endl;
+        result.op = OP_UNKNOWN;
         break;
     }
-    return;
+    return result;
 }
 
 /**
@@ -201,68 +1090,93 @@ void tehCPUS::decode_and_execute(unsigned short int inst) {
  *   return from a subroutine, respectively. In addition, all other instructions
  *   are used to run native machine code. This feature is not implimented, and
  *   as such, it will be ignored.
+ *
+ * SUPERCHIP 1.1, and XO-CHIP, take over 0x00CN, 0x00FB, and 0x00FC to scroll
+ *   the screen. Everywhere else, these are left as native machine code calls.
  */
 
-void tehCPUS::decode_hex_0(unsigned short int inst) {
+tehCPUS::operation tehCPUS::decode_hex_0(unsigned short int inst) {
+    operation result = OP_0NNN_SYS;
+    bool scrolling = (this->target == chippy::SUPERCHIP11)
+                  || (this->target == chippy::XOCHIP);
     switch (inst) {
+    case 0x00C0: case 0x00C1: case 0x00C2: case 0x00C3: // SCD
+    case 0x00C4: case 0x00C5: case 0x00C6: case 0x00C7:
+    case 0x00C8: case 0x00C9: case 0x00CA: case 0x00CB:
+    case 0x00CC: case 0x00CD: case 0x00CE: case 0x00CF:
+        result = scrolling ? OP_00CN_SCROLL_DOWN : OP_0NNN_SYS;
+        break;
     case 0x00E0: // CLS
-        this->I_00E0_CLS();
+        result = OP_00E0_CLS;
         break;
     case 0x00EE: // RET
-        this->I_00EE_RET();
+        result = OP_00EE_RET;
+        break;
+    case 0x00FB: // SCR
+        result = scrolling ? OP_00FB_SCROLL_RIGHT : OP_0NNN_SYS;
+        break;
+    case 0x00FC: // SCL
+        result = scrolling ? OP_00FC_SCROLL_LEFT : OP_0NNN_SYS;
         break;
     case 0x00FE: // DHI
-        this->I_00FE_DISABLE_HIRES();
+        result = OP_00FE_DISABLE_HIRES;
         break;
     case 0x00FF: // HIR
-        this->I_00FF_ENABLE_HIRES();
+        result = OP_00FF_ENABLE_HIRES;
         break;
     default:
         // STUB - Calls subroutine in RCA 1802 microprocessor. Not emulated.
+        result = OP_0NNN_SYS;
         break;
     }
+    return result;
 }
 
 /**
  * This bank of instructions are used to handle various register operations. 
  */
 
-void tehCPUS::decode_hex_8(unsigned short int inst) {
+tehCPUS::operation tehCPUS::decode_hex_8(unsigned short int inst) {
+    operation result = OP_UNKNOWN;
     switch (inst & 0xF) {
     case 0x0: // CPR
-        this->I_8XY0_COPY_X_TO_Y(inst);
+        result = OP_8XY0_COPY_X_TO_Y;
         break;
     case 0x1: // OR
-        this->I_8XY1_OR_X_WITH_Y(inst);
+        result = (this->quirks & QUIRK_VF_RESET)
+               ? OP_8XY1_OR_X_WITH_Y : OP_8XY1_OR_X_WITH_Y_KEEP_VF;
         break;
     case 0x2: // AND
-        this->I_8XY2_AND_X_WITH_Y(inst);
+        result = (this->quirks & QUIRK_VF_RESET)
+               ? OP_8XY2_AND_X_WITH_Y : OP_8XY2_AND_X_WITH_Y_KEEP_VF;
         break;
     case 0x3: // XOR
-        this->I_8XY3_XOR_X_WITH_Y(inst);
+        result = (this->quirks & QUIRK_VF_RESET)
+               ? OP_8XY3_XOR_X_WITH_Y : OP_8XY3_XOR_X_WITH_Y_KEEP_VF;
         break;
     case 0x4: // ADDR
-        this->I_8XY4_ADD_X_AND_Y(inst);
+        result = OP_8XY4_ADD_X_AND_Y;
         break;
     case 0x5: // SUBR
-        this->I_8XY5_SUB_Y_FROM_X(inst);
+        result = OP_8XY5_SUB_Y_FROM_X;
         break;
     case 0x6: // SHR
-        this->I_8XZ6_SHIFT_X_RIGHT(inst);
+        result = (this->quirks & QUIRK_SHIFT_VY)
+               ? OP_8XY6_SHIFT_Y_RIGHT : OP_8XZ6_SHIFT_X_RIGHT;
         break;
     case 0x7: // SUBRN
-        this->I_8XY7_SUB_X_FROM_Y(inst);
+        result = OP_8XY7_SUB_X_FROM_Y;
         break;
     case 0xE: // SHL
-        this->I_8XZE_SHIFT_X_LEFT(inst);
+        result = (this->quirks & QUIRK_SHIFT_VY)
+               ? OP_8XYE_SHIFT_Y_LEFT : OP_8XZE_SHIFT_X_LEFT;
         break;
     default:
-        // Malformed instruction - Throw error
-        // throw std::out_of_range(build_unknown_instruction_error(inst).c_str());
-        std::cout << build_unknown_instruction_error(inst) << std::endl;
+        // Malformed instruction - Reported when executed.
+        result = OP_UNKNOWN;
         break;
     }
-    return;
+    return result;
 }
 
 /**
@@ -270,20 +1184,20 @@ void tehCPUS::decode_hex_8(unsigned short int inst) {
  *   or not.
  */
 
-void tehCPUS::decode_hex_E(unsigned short int inst) {
+tehCPUS::operation tehCPUS::decode_hex_E(unsigned short int inst) {
+    operation result = OP_UNKNOWN;
     switch(this->bitsNN(inst)) {
     case 0x9E: // SKP
-        this->I_EX9E_SKIP_IF_KEY(inst);
+        result = OP_EX9E_SKIP_IF_KEY;
         break;
     case 0xA1: // SKNP
-        this->I_EXA1_SKIP_IF_NO_KEY(inst);
+        result = OP_EXA1_SKIP_IF_NO_KEY;
         break;
     default: // NOOP
-        // throw std::out_of_range(build_unknown_instruction_error(inst).c_str());
-        std::cout << build_unknown_instruction_error(inst) << std::endl;
+        result = OP_UNKNOWN;
         break;
     }
-    return;
+    return result;
 }
 
 /**
@@ -291,43 +1205,290 @@ void tehCPUS::decode_hex_E(unsigned short int inst) {
  *   and the system memory.
  */
 
-void tehCPUS::decode_hex_F(unsigned short int inst) {
+tehCPUS::operation tehCPUS::decode_hex_F(unsigned short int inst) {
+    operation result = OP_UNKNOWN;
     switch(this->bitsNN(inst)) {
+    case 0x00: // LDIL
+        result = (inst == 0xF000 && this->target == chippy::XOCHIP)
+               ? OP_F000_LOAD_LONG_IREG : OP_UNKNOWN;
+        break;
+    case 0x01: // PLANE
+        result = (this->target == chippy::XOCHIP)
+               ? OP_FN01_SELECT_PLANES : OP_UNKNOWN;
+        break;
     case 0x07: // RDDT
-        this->I_FX07_READ_DISPLAY_TIMER(inst);
+        result = OP_FX07_READ_DISPLAY_TIMER;
         break;
     case 0x0A: // LDK
-        this->I_FX0A_READ_KEY(inst);
+        result = OP_FX0A_READ_KEY;
         break;
     case 0x15: // LDDT
-        this->I_FX15_SET_DISPLAY_TIMER(inst);
+        result = OP_FX15_SET_DISPLAY_TIMER;
         break;
     case 0x18: // LDST
-        this->I_FX18_SET_SOUND_TIMER(inst);
+        result = OP_FX18_SET_SOUND_TIMER;
         break;
     case 0x1E: // ADDI
-        this->I_FX1E_ADD_VX_TO_I(inst);
+        result = OP_FX1E_ADD_VX_TO_I;
         break;
     case 0x29: // LDSV
-        this->I_FX29_LOAD_HEX_SPRITE(inst);
+        result = OP_FX29_LOAD_HEX_SPRITE;
         break;
     case 0x33: // SAVEB
-        this->I_FX33_SAVE_BCD_VALUE(inst);
+        result = OP_FX33_SAVE_BCD_VALUE;
         break;
     case 0x55: // SAVEN
-        this->I_FX55_SAVE_REGISTERS(inst);
+        result = (this->quirks & QUIRK_IREG_INCREMENT)
+               ? OP_FX55_SAVE_REGISTERS : OP_FX55_SAVE_REGISTERS_HP48;
         break;
     case 0x65: // LOADN
-        this->I_FX65_LOAD_REGISTERS(inst);
+        result = (this->quirks & QUIRK_IREG_INCREMENT)
+               ? OP_FX65_LOAD_REGISTERS : OP_FX65_LOAD_REGISTERS_HP48;
         break;
     default: // NOOP
-        // throw std::out_of_range(build_unknown_instruction_error(inst).c_str());
-        std::cout << build_unknown_instruction_error(inst) << std::endl;
+        result = OP_UNKNOWN;
+        break;
+    }
+    return result;
+}
+
+/**
+ * Every possible 16-bit word is decoded up front. Since the decoding depends on
+ *   nothing but the instruction itself, and our quirks mode, this only ever has
+ *   to happen once, when the processor is built.
+ */
+
+void tehCPUS::build_decode_table() {
+    for (unsigned int i = 0; i < DECODE_TABLE_SIZE; i++) {
+        this->decode_table[i] = this->decode((unsigned short int) i);
+    }
+    return;
+}
+
+/**
+ * With the decoding already done, executing an instruction is a single indexed
+ *   jump to its handler. The compiler is free to inline the handlers here.
+ */
+
+void tehCPUS::execute(const instruction& inst) {
+    switch (inst.op) {
+    case OP_UNKNOWN:
+        this->I_UNKNOWN(inst);
+        break;
+    case OP_0NNN_SYS:
+        this->I_0NNN_SYS(inst);
+        break;
+    case OP_00CN_SCROLL_DOWN:
+        this->I_00CN_SCROLL_DOWN(inst);
+        break;
+    case OP_00E0_CLS:
+        this->I_00E0_CLS(inst);
+        break;
+    case OP_00EE_RET:
+        this->I_00EE_RET(inst);
+        break;
+    case OP_00FB_SCROLL_RIGHT:
+        this->I_00FB_SCROLL_RIGHT(inst);
+        break;
+    case OP_00FC_SCROLL_LEFT:
+        this->I_00FC_SCROLL_LEFT(inst);
+        break;
+    case OP_00FE_DISABLE_HIRES:
+        this->I_00FE_DISABLE_HIRES(inst);
+        break;
+    case OP_00FF_ENABLE_HIRES:
+        this->I_00FF_ENABLE_HIRES(inst);
+        break;
+    case OP_1NNN_JMP:
+        this->I_1NNN_JMP(inst);
+        break;
+    case OP_2NNN_CALL:
+        this->I_2NNN_CALL(inst);
+        break;
+    case OP_3XNN_SKIP_IF_EQUAL:
+        this->I_3XNN_SKIP_IF_EQUAL(inst);
+        break;
+    case OP_4XNN_SKIP_IF_NOT_EQUAL:
+        this->I_4XNN_SKIP_IF_NOT_EQUAL(inst);
+        break;
+    case OP_5XY0_SKIP_IF_X_EQ_Y:
+        this->I_5XY0_SKIP_IF_X_EQ_Y(inst);
+        break;
+    case OP_5XY2_SAVE_RANGE:
+        this->I_5XY2_SAVE_RANGE(inst);
+        break;
+    case OP_5XY3_LOAD_RANGE:
+        this->I_5XY3_LOAD_RANGE(inst);
+        break;
+    case OP_6XNN_LOAD_NN_TO_X:
+        this->I_6XNN_LOAD_NN_TO_X(inst);
+        break;
+    case OP_7XNN_ADD_NN_TO_X:
+        this->I_7XNN_ADD_NN_TO_X(inst);
+        break;
+    case OP_8XY0_COPY_X_TO_Y:
+        this->I_8XY0_COPY_X_TO_Y(inst);
+        break;
+    case OP_8XY1_OR_X_WITH_Y:
+        this->I_8XY1_OR_X_WITH_Y<true>(inst);
+        break;
+    case OP_8XY1_OR_X_WITH_Y_KEEP_VF:
+        this->I_8XY1_OR_X_WITH_Y<false>(inst);
+        break;
+    case OP_8XY2_AND_X_WITH_Y:
+        this->I_8XY2_AND_X_WITH_Y<true>(inst);
+        break;
+    case OP_8XY2_AND_X_WITH_Y_KEEP_VF:
+        this->I_8XY2_AND_X_WITH_Y<false>(inst);
+        break;
+    case OP_8XY3_XOR_X_WITH_Y:
+        this->I_8XY3_XOR_X_WITH_Y<true>(inst);
+        break;
+    case OP_8XY3_XOR_X_WITH_Y_KEEP_VF:
+        this->I_8XY3_XOR_X_WITH_Y<false>(inst);
+        break;
+    case OP_8XY4_ADD_X_AND_Y:
+        this->I_8XY4_ADD_X_AND_Y(inst);
+        break;
+    case OP_8XY5_SUB_Y_FROM_X:
+        this->I_8XY5_SUB_Y_FROM_X(inst);
+        break;
+    case OP_8XZ6_SHIFT_X_RIGHT:
+        this->I_8XZ6_SHIFT_X_RIGHT<false>(inst);
+        break;
+    case OP_8XY6_SHIFT_Y_RIGHT:
+        this->I_8XZ6_SHIFT_X_RIGHT<true>(inst);
+        break;
+    case OP_8XY7_SUB_X_FROM_Y:
+        this->I_8XY7_SUB_X_FROM_Y(inst);
+        break;
+    case OP_8XZE_SHIFT_X_LEFT:
+        this->I_8XZE_SHIFT_X_LEFT<false>(inst);
+        break;
+    case OP_8XYE_SHIFT_Y_LEFT:
+        this->I_8XZE_SHIFT_X_LEFT<true>(inst);
+        break;
+    case OP_9XY0_SKIP_IF_X_NE_Y:
+        this->I_9XY0_SKIP_IF_X_NE_Y(inst);
+        break;
+    case OP_ANNN_LOAD_IREG:
+        this->I_ANNN_LOAD_IREG(inst);
+        break;
+    case OP_BNNN_JUMP_TO_OFFSET:
+        this->I_BNNN_JUMP_TO_OFFSET<false>(inst);
+        break;
+    case OP_BXNN_JUMP_TO_OFFSET:
+        this->I_BNNN_JUMP_TO_OFFSET<true>(inst);
+        break;
+    case OP_CXNN_RANDOM:
+        this->I_CXNN_RANDOM(inst);
+        break;
+    case OP_DXYN_DRAW:
+        this->I_DXYN_DRAW<true>(inst);
+        break;
+    case OP_DXYN_DRAW_NO_WAIT:
+        this->I_DXYN_DRAW<false>(inst);
+        break;
+    case OP_EX9E_SKIP_IF_KEY:
+        this->I_EX9E_SKIP_IF_KEY(inst);
+        break;
+    case OP_EXA1_SKIP_IF_NO_KEY:
+        this->I_EXA1_SKIP_IF_NO_KEY(inst);
+        break;
+    case OP_F000_LOAD_LONG_IREG:
+        this->I_F000_LOAD_LONG_IREG(inst);
+        break;
+    case OP_FX07_READ_DISPLAY_TIMER:
+        this->I_FX07_READ_DISPLAY_TIMER(inst);
+        break;
+    case OP_FX0A_READ_KEY:
+        this->I_FX0A_READ_KEY(inst);
+        break;
+    case OP_FX15_SET_DISPLAY_TIMER:
+        this->I_FX15_SET_DISPLAY_TIMER(inst);
+        break;
+    case OP_FX18_SET_SOUND_TIMER:
+        this->I_FX18_SET_SOUND_TIMER(inst);
+        break;
+    case OP_FX1E_ADD_VX_TO_I:
+        this->I_FX1E_ADD_VX_TO_I(inst);
+        break;
+    case OP_FX29_LOAD_HEX_SPRITE:
+        this->I_FX29_LOAD_HEX_SPRITE(inst);
+        break;
+    case OP_FX33_SAVE_BCD_VALUE:
+        this->I_FX33_SAVE_BCD_VALUE(inst);
+        break;
+    case OP_FX55_SAVE_REGISTERS:
+        this->I_FX55_SAVE_REGISTERS<true>(inst);
+        break;
+    case OP_FX55_SAVE_REGISTERS_HP48:
+        this->I_FX55_SAVE_REGISTERS<false>(inst);
+        break;
+    case OP_FX65_LOAD_REGISTERS:
+        this->I_FX65_LOAD_REGISTERS<true>(inst);
+        break;
+    case OP_FX65_LOAD_REGISTERS_HP48:
+        this->I_FX65_LOAD_REGISTERS<false>(inst);
+        break;
+    case OP_FN01_SELECT_PLANES:
+        this->I_FN01_SELECT_PLANES(inst);
+        break;
+    case OP_ANNN_DXYN_LOAD_AND_DRAW:
+        this->F_ANNN_DXYN_LOAD_AND_DRAW<true>(inst);
+        break;
+    case OP_ANNN_DXYN_LOAD_AND_DRAW_NO_WAIT:
+        this->F_ANNN_DXYN_LOAD_AND_DRAW<false>(inst);
+        break;
+    case OP_ANNN_FX1E_LOAD_AND_OFFSET:
+        this->F_ANNN_FX1E_LOAD_AND_OFFSET(inst);
+        break;
+    case OP_6XNN_6YNN_LOAD_PAIR:
+        this->F_6XNN_6YNN_LOAD_PAIR(inst);
+        break;
+    case OP_3XNN_1NNN_JUMP_IF_NOT_EQUAL:
+        this->F_3XNN_1NNN_JUMP_IF_NOT_EQUAL(inst);
+        break;
+    case OP_4XNN_1NNN_JUMP_IF_EQUAL:
+        this->F_4XNN_1NNN_JUMP_IF_EQUAL(inst);
+        break;
+    default:
+        this->I_UNKNOWN(inst);
         break;
     }
+    return;
 }
 
-void tehCPUS::I_00E0_CLS() {
+/**
+ * Unknown instructions are not fatal. We report them, and carry on as if they
+ *   were a NOOP.
+ */
+
+void tehCPUS::I_UNKNOWN(const instruction& inst) {
+    // throw std::out_of_range(build_unknown_instruction_error(inst.raw).c_str());
+    std::cout << build_unknown_instruction_error(inst.raw) << std::endl;
+    return;
+}
+
+void tehCPUS::I_0NNN_SYS(const instruction&) {
+    // STUB - Calls subroutine in RCA 1802 microprocessor. Not emulated.
+    return;
+}
+
+/**
+ * The framebuffer is always kept at full resolution, and low resolution mode 
+ *   only doubles sprite coordinates, so the scroll distance is counted in
+ *   framebuffer pixels. This is what lets SUPERCHIP 1.1 scroll by half a 
+ *   pixel in low resolution mode. XO-CHIP scrolls by whole pixels in either
+ *   mode, so scroll_scale() doubles the distance for it in low resolution.
+ */
+
+void tehCPUS::I_00CN_SCROLL_DOWN(const instruction& inst) {
+    this->bus->scroll_down(inst.N * this->scroll_scale());
+    return;
+}
+
+void tehCPUS::I_00E0_CLS(const instruction&) {
     this->bus->blank_screen();
     return;
 }
@@ -338,7 +1499,7 @@ void tehCPUS::I_00E0_CLS() {
  *   (this->SPreg).
  */
 
-void tehCPUS::I_00EE_RET() {
+void tehCPUS::I_00EE_RET(const instruction&) {
     // if SPreg == 0, then do nothing.
     if (this->SPreg == 0) {
         // std::__throw_domain_error("SPreg OOB");
@@ -352,7 +1513,17 @@ void tehCPUS::I_00EE_RET() {
     return;
 }
 
-void tehCPUS::I_00FE_DISABLE_HIRES() {
+void tehCPUS::I_00FB_SCROLL_RIGHT(const instruction&) {
+    this->bus->scroll_right(4 * this->scroll_scale());
+    return;
+}
+
+void tehCPUS::I_00FC_SCROLL_LEFT(const instruction&) {
+    this->bus->scroll_left(4 * this->scroll_scale());
+    return;
+}
+
+void tehCPUS::I_00FE_DISABLE_HIRES(const instruction&) {
     if (IS_SUPERCHIP(this->target)) {
         this->bus->set_video_mode(true);
         // this->bus->set_resolution(64, 32);
@@ -360,7 +1531,7 @@ void tehCPUS::I_00FE_DISABLE_HIRES() {
     return;
 }
 
-void tehCPUS::I_00FF_ENABLE_HIRES() {
+void tehCPUS::I_00FF_ENABLE_HIRES(const instruction&) {
     if (IS_SUPERCHIP(this->target)) {
         this->bus->set_video_mode(false);
         // this->bus->set_resolution(128, 64);
@@ -368,11 +1539,11 @@ void tehCPUS::I_00FF_ENABLE_HIRES() {
     return;
 }
 
-void tehCPUS::I_1NNN_JMP(unsigned short int inst) {
+void tehCPUS::I_1NNN_JMP(const instruction& inst) {
     // We implement PC *after* running the instruction, so we decrement by two
     // to stop an off-by-one. We could probably return a bool to control whether
     // we should clock or not? Eh, this works.
-    this->PC = this->bitsNNN(inst) - 2;
+    this->PC = inst.NNN - 2;
     return;
 }
 
@@ -383,7 +1554,7 @@ void tehCPUS::I_1NNN_JMP(unsigned short int inst) {
  *   jumping the program counter to the given location.
  * 
  */
-void tehCPUS::I_2NNN_CALL(unsigned short int inst) {
+void tehCPUS::I_2NNN_CALL(const instruction& inst) {
     // Save current PC to stack
     this->stackFile[this->SPreg] = this->PC;
     // If SPreg > 15 send error
@@ -405,9 +1576,9 @@ void tehCPUS::I_2NNN_CALL(unsigned short int inst) {
  *   instruction (0x00NN).
  */
 
-void tehCPUS::I_3XNN_SKIP_IF_EQUAL(unsigned short int inst) {
-    if (this->regFile[this->bitN(inst, 2)] == this->bitsNN(inst)) {
-        this->PC = this->PC + 2;
+void tehCPUS::I_3XNN_SKIP_IF_EQUAL(const instruction& inst) {
+    if (this->regFile[inst.X] == inst.NN) {
+        this->PC = this->PC + this->skip_length(this->PC);
     } // else do_nothing();
     return;
 }
@@ -416,9 +1587,9 @@ void tehCPUS::I_3XNN_SKIP_IF_EQUAL(unsigned short int inst) {
  * This is the inverse of I_3XNN_SKIP_IF_EQUAl.
  */
 
-void tehCPUS::I_4XNN_SKIP_IF_NOT_EQUAL(unsigned short int inst) {
-    if (this->regFile[this->bitN(inst, 2)] != this->bitsNN(inst)) {
-        this->PC = this->PC + 2;
+void tehCPUS::I_4XNN_SKIP_IF_NOT_EQUAL(const instruction& inst) {
+    if (this->regFile[inst.X] != inst.NN) {
+        this->PC = this->PC + this->skip_length(this->PC);
     }
     return;
 }
@@ -428,10 +1599,57 @@ void tehCPUS::I_4XNN_SKIP_IF_NOT_EQUAL(unsigned short int inst) {
  *   (this->regFile[x], this->regFile[y]) are equal.
  */
 
-void tehCPUS::I_5XY0_SKIP_IF_X_EQ_Y(unsigned short int inst) {
-    if (this->regFile[this->bitN(inst, 2)] 
-                            == this->regFile[this->bitN(inst, 1)]) {
-        this->PC = this->PC + 2;
+void tehCPUS::I_5XY0_SKIP_IF_X_EQ_Y(const instruction& inst) {
+    if (this->regFile[inst.X] 
+                            == this->regFile[inst.Y]) {
+        this->PC = this->PC + this->skip_length(this->PC);
+    }
+    return;
+}
+
+/**
+ * XO-CHIP
+ * SAVE Vx - Vy - (0x5XY2)
+ * 
+ * Unlike FX55, this leaves I alone. The registers are written in one go, and 
+ *   if X is greater than Y, they are written in reverse order.
+ */
+
+void tehCPUS::I_5XY2_SAVE_RANGE(const instruction& inst) {
+    int len = 0;
+    if (inst.X <= inst.Y) {
+        len = inst.Y - inst.X + 1;
+        this->bus->write_span(this->Ireg, &this->regFile[inst.X], len);
+    } else {
+        unsigned char data[16];
+        len = inst.X - inst.Y + 1;
+        for (int i = 0; i < len; i++) {
+            data[i] = this->regFile[inst.X - i];
+        }
+        this->bus->write_span(this->Ireg, data, len);
+    }
+    return;
+}
+
+/**
+ * XO-CHIP
+ * LOAD Vx - Vy - (0x5XY3)
+ * 
+ * The same as 5XY2, but the other way around.
+ */
+
+void tehCPUS::I_5XY3_LOAD_RANGE(const instruction& inst) {
+    int len = 0;
+    if (inst.X <= inst.Y) {
+        len = inst.Y - inst.X + 1;
+        this->bus->read_span(this->Ireg, &this->regFile[inst.X], len);
+    } else {
+        unsigned char data[16];
+        len = inst.X - inst.Y + 1;
+        this->bus->read_span(this->Ireg, data, len);
+        for (int i = 0; i < len; i++) {
+            this->regFile[inst.X - i] = data[i];
+        }
     }
     return;
 }
@@ -440,8 +1658,8 @@ void tehCPUS::I_5XY0_SKIP_IF_X_EQ_Y(unsigned short int inst) {
  * Loads the value 0xNN into register X (this->regFile[X] = 0xNN)
  */
 
-void tehCPUS::I_6XNN_LOAD_NN_TO_X(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] = this->bitsNN(inst);
+void tehCPUS::I_6XNN_LOAD_NN_TO_X(const instruction& inst) {
+    this->regFile[inst.X] = inst.NN;
     return;
 }
 
@@ -450,36 +1668,44 @@ void tehCPUS::I_6XNN_LOAD_NN_TO_X(unsigned short int inst) {
  *   (this->regFile[X] = this->regFile[X] + 0xNN)
  */
 
-void tehCPUS::I_7XNN_ADD_NN_TO_X(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
-    this->regFile[regx] = this->regFile[regx] + this->bitsNN(inst);
+void tehCPUS::I_7XNN_ADD_NN_TO_X(const instruction& inst) {
+    unsigned char regx = inst.X;
+    this->regFile[regx] = this->regFile[regx] + inst.NN;
     return;
 }
 
-
-void tehCPUS::I_8XY0_COPY_X_TO_Y(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] = this->regFile[this->bitN(inst, 1)];
+void tehCPUS::I_8XY0_COPY_X_TO_Y(const instruction& inst) {
+    this->regFile[inst.X] = this->regFile[inst.Y];
     return;
 }
 
-void tehCPUS::I_8XY1_OR_X_WITH_Y(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] |= this->regFile[this->bitN(inst, 1)];
+template<bool RESET_VF>
+void tehCPUS::I_8XY1_OR_X_WITH_Y(const instruction& inst) {
+    this->regFile[inst.X] |= this->regFile[inst.Y];
 // Chip-8 quirk- OR, AND, XOR instructions reset Vf to 0.
-    this->regFile[0xF] = 0;
+    if (RESET_VF) {
+        this->regFile[0xF] = 0;
+    } // else do_nothing()
     return;
 }
 
-void tehCPUS::I_8XY2_AND_X_WITH_Y(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] &= this->regFile[this->bitN(inst, 1)];
-// Chip-8 quirk- OR, AND, XOR instructions reset Vf to 0.    
-    this->regFile[0xF] = 0;
+template<bool RESET_VF>
+void tehCPUS::I_8XY2_AND_X_WITH_Y(const instruction& inst) {
+    this->regFile[inst.X] &= this->regFile[inst.Y];
+// Chip-8 quirk- OR, AND, XOR instructions reset Vf to 0.
+    if (RESET_VF) {
+        this->regFile[0xF] = 0;
+    } // else do_nothing()
     return;
 }
 
-void tehCPUS::I_8XY3_XOR_X_WITH_Y(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] ^= this->regFile[this->bitN(inst, 1)];
+template<bool RESET_VF>
+void tehCPUS::I_8XY3_XOR_X_WITH_Y(const instruction& inst) {
+    this->regFile[inst.X] ^= this->regFile[inst.Y];
 // Chip-8 quirk- OR, AND, XOR instructions reset Vf to 0.
-    this->regFile[0xF] = 0;
+    if (RESET_VF) {
+        this->regFile[0xF] = 0;
+    } // else do_nothing()
     return;
 }
 
@@ -489,10 +1715,10 @@ void tehCPUS::I_8XY3_XOR_X_WITH_Y(unsigned short int inst) {
  *   save the result to Vx.
  */
 
-void tehCPUS::I_8XY4_ADD_X_AND_Y(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
+void tehCPUS::I_8XY4_ADD_X_AND_Y(const instruction& inst) {
+    unsigned char regx = inst.X;
     unsigned short int temp = ((unsigned short int) this->regFile[regx]) 
-                   + ((unsigned short int) this->regFile[this->bitN(inst, 1)]);
+                   + ((unsigned short int) this->regFile[inst.Y]);
 
     // It is possible to use Register 0xF as the destination. The carry flag 
     // supercedes saving the result, so make sure the carry flag is handled 
@@ -513,9 +1739,9 @@ void tehCPUS::I_8XY4_ADD_X_AND_Y(unsigned short int inst) {
  *   Register Y.
  */
 
-void tehCPUS::I_8XY5_SUB_Y_FROM_X(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
-    unsigned char regy = this->bitN(inst, 1);
+void tehCPUS::I_8XY5_SUB_Y_FROM_X(const instruction& inst) {
+    unsigned char regx = inst.X;
+    unsigned char regy = inst.Y;
 // We must calculate the borrow *before* the subtraction, and apply it *after*
     unsigned char borrow = 1;
     if (this->regFile[regx] < this->regFile[regy]) {
@@ -534,12 +1760,13 @@ void tehCPUS::I_8XY5_SUB_Y_FROM_X(unsigned short int inst) {
  * Here, we are treating Z as a 'don't care'.
  */
 
-void tehCPUS::I_8XZ6_SHIFT_X_RIGHT(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
-    unsigned char regy = this->bitN(inst, 1);
+template<bool SHIFT_VY>
+void tehCPUS::I_8XZ6_SHIFT_X_RIGHT(const instruction& inst) {
+    unsigned char regx = inst.X;
+    unsigned char regy = inst.Y;
     // CHIP-8 Quirk: Y is not copied in later interpreters.
-    if (this->target == chippy::CHIP8) {
-    this->regFile[regx] = this->regFile[regy];
+    if (SHIFT_VY) {
+        this->regFile[regx] = this->regFile[regy];
     } // else do_nothing()
     // Save LSB, before shifting.
     unsigned char LSB = this->regFile[regx] & 0x1;
@@ -555,9 +1782,9 @@ void tehCPUS::I_8XZ6_SHIFT_X_RIGHT(unsigned short int inst) {
  *   Register Y.
  */
 
-void tehCPUS::I_8XY7_SUB_X_FROM_Y(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
-    unsigned char regy = this->bitN(inst, 1);
+void tehCPUS::I_8XY7_SUB_X_FROM_Y(const instruction& inst) {
+    unsigned char regx = inst.X;
+    unsigned char regy = inst.Y;
     unsigned char borrow = 1;
     if (this->regFile[regy] < this->regFile[regx]) {
         borrow = 0;
@@ -575,13 +1802,14 @@ void tehCPUS::I_8XY7_SUB_X_FROM_Y(unsigned short int inst) {
  * Here, we are treating Z as a 'Don't care'.
  */
 
-void tehCPUS::I_8XZE_SHIFT_X_LEFT(unsigned short int inst) {
-    unsigned char regx = this->bitN(inst, 2);
-    unsigned char regy = this->bitN(inst, 1);
+template<bool SHIFT_VY>
+void tehCPUS::I_8XZE_SHIFT_X_LEFT(const instruction& inst) {
+    unsigned char regx = inst.X;
+    unsigned char regy = inst.Y;
     // CHIP-8 Quirk: Y is not copied in later interpreters.
-    if (this->target == chippy::CHIP8) {
-    this->regFile[regx] = this->regFile[regy];
-    }
+    if (SHIFT_VY) {
+        this->regFile[regx] = this->regFile[regy];
+    } // else do_nothing()
     // Save MSB, before shifting.
     unsigned char MSB = (this->regFile[regx] & 0x80) >> 7;
     this->regFile[regx] <<= 1;
@@ -595,16 +1823,16 @@ void tehCPUS::I_8XZE_SHIFT_X_LEFT(unsigned short int inst) {
  *   If they are not equal, then we increment the Program Counter.
  */
 
-void tehCPUS::I_9XY0_SKIP_IF_X_NE_Y(unsigned short int inst) {
-    if (this->regFile[this->bitN(inst, 2)] 
-                                        != this->regFile[this->bitN(inst, 1)]) {
-        this->PC = this->PC + 2;
+void tehCPUS::I_9XY0_SKIP_IF_X_NE_Y(const instruction& inst) {
+    if (this->regFile[inst.X] 
+                                        != this->regFile[inst.Y]) {
+        this->PC = this->PC + this->skip_length(this->PC);
     }
     return;
 }
 
-void tehCPUS::I_ANNN_LOAD_IREG(unsigned short int inst) {
-    this->Ireg = this->bitsNNN(inst);
+void tehCPUS::I_ANNN_LOAD_IREG(const instruction& inst) {
+    this->Ireg = inst.NNN;
     return;
 }
 
@@ -613,13 +1841,16 @@ void tehCPUS::I_ANNN_LOAD_IREG(unsigned short int inst) {
  *   instruction, we must decrement the PC by two.
  * 
  * (this->PC = this->regFile[0] + 0xNNN - 2)
+ * 
+ * CHIP-48 Quirk: The CHIP-48 family reads this as BXNN, and jumps to Vx + 0xNN.
  */
 
-void tehCPUS::I_BNNN_JUMP_TO_OFFSET(unsigned short int inst) {
-    if (this->target == chippy::CHIP8) {
-    this->PC = this->regFile[0x0] + this->bitsNNN(inst) - 2;
-    } else if (IS_HP48(this->target)) {
-        this->PC = this->regFile[(int) this->bitN(inst, 2)] + this->bitsNN(inst) - 2;
+template<bool JUMP_VX>
+void tehCPUS::I_BNNN_JUMP_TO_OFFSET(const instruction& inst) {
+    if (JUMP_VX) {
+        this->PC = this->regFile[(int) inst.X] + inst.NN - 2;
+    } else {
+        this->PC = this->regFile[0x0] + inst.NNN - 2;
     }
     return;
 }
@@ -633,9 +1864,9 @@ void tehCPUS::I_BNNN_JUMP_TO_OFFSET(unsigned short int inst) {
  * (this->regFile[x] = RAND() & 0xNN).
  */
 
-void tehCPUS::I_CXNN_RANDOM(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] = this->dist(this->generator) 
-                                & this->bitsNN(inst);
+void tehCPUS::I_CXNN_RANDOM(const instruction& inst) {
+    this->regFile[inst.X] = this->dist(this->generator) 
+                                & inst.NN;
     return;
 }
 
@@ -652,47 +1883,68 @@ void tehCPUS::I_CXNN_RANDOM(unsigned short int inst) {
  * SUPERCHIP 1.0
  * DRAW Vx, Vy - (0xDxy0) 
  * 
- * This variant will draw a 16x16 size sprite.
+ * This variant will draw a 16x16 size sprite. The decoder has already swapped
+ *   the length for 16, so there is nothing special to do here.
+ *
+ * SUPERCHIP 1.1
+ * 
+ * In hi-res mode, VF is set to the number of sprite rows that collided, or
+ *   were clipped by the bottom of the screen, rather than just 1 or 0.
  */
-void tehCPUS::I_DXYN_DRAW(unsigned short int inst) {
-    int len = bitN(inst, 0);
-    int fetX = this->regFile[this->bitN(inst, 2)];
-    int fetY = this->regFile[this->bitN(inst, 1)];
+template<bool DISPLAY_WAIT>
+void tehCPUS::I_DXYN_DRAW(const instruction& inst) {
+    int len = inst.N;
+    int fetX = this->regFile[inst.X];
+    int fetY = this->regFile[inst.Y];
     int fetI = this->Ireg;
 
-    bool result = false;
+    int rows = this->bus->copy_sprite(fetX, fetY, fetI, len);
 
-    if (len == 0 && this->target == chippy::SUPERCHIP10) {
-        result = this->bus->copy_sprite(fetX, fetY, fetI, 16);
-    } else {
-        result = this->bus->copy_sprite(fetX, fetY, fetI, len);
-    }
-
-    if (result) {
+    if (this->target == chippy::SUPERCHIP11 && !this->bus->get_video_mode()) {
+        this->regFile[0xF] = rows;
+    } else if (rows != 0) {
         this->regFile[0xF] = 1;
     } else {
         this->regFile[0xF] = 0;
     }
-    this->vblank_quirk_block = true;
+    if (DISPLAY_WAIT) {
+        this->vblank_quirk_block = true;
+    } // else do_nothing()
     return;
 }
 
-void tehCPUS::I_EX9E_SKIP_IF_KEY(unsigned short int inst) {
-    if (this->bus->test_key(this->regFile[this->bitN(inst, 2)])) {
-        this->PC = this->PC + 2;
+void tehCPUS::I_EX9E_SKIP_IF_KEY(const instruction& inst) {
+    if (this->bus->test_key(this->regFile[inst.X])) {
+        this->PC = this->PC + this->skip_length(this->PC);
     } // else, do_nothing();
     return;
 }
 
-void tehCPUS::I_EXA1_SKIP_IF_NO_KEY(unsigned short int inst) {
-    if (!this->bus->test_key(this->regFile[this->bitN(inst, 2)])) {
-        this->PC = this-> PC + 2;
+void tehCPUS::I_EXA1_SKIP_IF_NO_KEY(const instruction& inst) {
+    if (!this->bus->test_key(this->regFile[inst.X])) {
+        this->PC = this->PC + this->skip_length(this->PC);
     } // else, do_nothing();
     return;
 }
 
-void tehCPUS::I_FX07_READ_DISPLAY_TIMER(unsigned short int inst) {
-    this->regFile[this->bitN(inst, 2)] = this->DTreg;
+/**
+ * XO-CHIP
+ * LDIL NNNN - (0xF000, 0xNNNN)
+ * 
+ * This is the only instruction four bytes long. The address is read straight
+ *   out of the second half, which we then step over, so the usual increment
+ *   afterwards lands on the next instruction.
+ */
+
+void tehCPUS::I_F000_LOAD_LONG_IREG(const instruction&) {
+    this->Ireg = (this->bus->read_ram(this->PC + 2) << 8) 
+               | this->bus->read_ram(this->PC + 3);
+    this->PC = this->PC + 2;
+    return;
+}
+
+void tehCPUS::I_FX07_READ_DISPLAY_TIMER(const instruction& inst) {
+    this->regFile[inst.X] = this->DTreg;
     return;
 }
 
@@ -702,8 +1954,8 @@ void tehCPUS::I_FX07_READ_DISPLAY_TIMER(unsigned short int inst) {
  *   scancode into Register Vx.
  */
 
-void tehCPUS::I_FX0A_READ_KEY(unsigned short int inst) {
-    unsigned char temp = this->bitN(inst, 2);
+void tehCPUS::I_FX0A_READ_KEY(const instruction& inst) {
+    unsigned char temp = inst.X;
     // We're doing this a little bit out of order! This is fine.
     // If we read in the keys and *then* test while looping over this instr-
     //  uction, we would overwrite the recorded key every time. 
@@ -711,6 +1963,7 @@ void tehCPUS::I_FX0A_READ_KEY(unsigned short int inst) {
         // If the key is still being held, beep and remain halted
         if (this->bus->test_key(this->regFile[temp])) {
             this->STreg = 4;
+            this->sound_edge(true, this->cycle_stamp);
         } else if (this->STreg == 0) {
             this->haltPC = false;
         }
@@ -721,27 +1974,27 @@ void tehCPUS::I_FX0A_READ_KEY(unsigned short int inst) {
     return;
 }
 
-void tehCPUS::I_FX15_SET_DISPLAY_TIMER(unsigned short int inst) {
-    this->DTreg = this->regFile[this->bitN(inst, 2)];
+void tehCPUS::I_FX15_SET_DISPLAY_TIMER(const instruction& inst) {
+    this->DTreg = this->regFile[inst.X];
     return;
 }
 
-void tehCPUS::I_FX18_SET_SOUND_TIMER(unsigned short int inst) {
-    this->STreg = this->regFile[this->bitN(inst, 2)];
+void tehCPUS::I_FX18_SET_SOUND_TIMER(const instruction& inst) {
+    this->STreg = this->regFile[inst.X];
+    this->sound_edge(this->STreg > 0, this->cycle_stamp);
     return;
 }
 
-void tehCPUS::I_FX1E_ADD_VX_TO_I(unsigned short int inst) {
-    this->Ireg = this->Ireg + this->regFile[this->bitN(inst, 2)];
+void tehCPUS::I_FX1E_ADD_VX_TO_I(const instruction& inst) {
+    this->Ireg = this->Ireg + this->regFile[inst.X];
     return;
 }
 
-void tehCPUS::I_FX29_LOAD_HEX_SPRITE(unsigned short int inst) {
-    this->Ireg = this->regFile[this->bitN(inst, 2)] * 5;
+void tehCPUS::I_FX29_LOAD_HEX_SPRITE(const instruction& inst) {
+    this->Ireg = this->regFile[inst.X] * 5;
     return;
 }
 
-
 /**
  * Convert the value stored in register Vx (this->regFile[x]) into a binary-
  *   coded-decimal, and store it in RAM at address I- Where the most significant
@@ -756,11 +2009,14 @@ void tehCPUS::I_FX29_LOAD_HEX_SPRITE(unsigned short int inst) {
  *   the decimal encoding of the hex value.
  */
 
-void tehCPUS::I_FX33_SAVE_BCD_VALUE(unsigned short int inst) {
-    int tempX = this->regFile[this->bitN(inst, 2)];
-    this->bus->write_ram(this->Ireg, ((tempX / 100) % 10));
-    this->bus->write_ram(this->Ireg+1, ((tempX / 10) % 10));
-    this->bus->write_ram(this->Ireg+2, ((tempX) % 10));
+void tehCPUS::I_FX33_SAVE_BCD_VALUE(const instruction& inst) {
+    int tempX = this->regFile[inst.X];
+    unsigned char digits[3] = {
+        (unsigned char) ((tempX / 100) % 10),
+        (unsigned char) ((tempX / 10) % 10),
+        (unsigned char) ((tempX) % 10)
+    };
+    this->bus->write_span(this->Ireg, digits, 3);
     return;
 }
 
@@ -768,16 +2024,17 @@ void tehCPUS::I_FX33_SAVE_BCD_VALUE(unsigned short int inst) {
  * Save the values of the CPU's main registers (this->regFile[]) in RAM at the
  *   location stored in the Ireg (this->ireg). We will only save the number of
  *   registers equal to x.
+ * 
+ * The registers are written in one go, and I is moved past them afterwards.
  */
 
-void tehCPUS::I_FX55_SAVE_REGISTERS(unsigned short int inst) {
-    int tempX = this->bitN(inst, 2);
-    for (unsigned char i = 0; i <= tempX; i++) {
-        this->bus->write_ram(this->Ireg, this->regFile[i]);
-        this->Ireg++;
-    }
+template<bool INCREMENT_I>
+void tehCPUS::I_FX55_SAVE_REGISTERS(const instruction& inst) {
+    int count = inst.X + 1;
+    this->bus->write_span(this->Ireg, this->regFile, count);
+    this->Ireg += count;
     // Bug in CHIP48, SUPERCHIP10, SUPERCHIP 11, ireg off by one
-    if (IS_HP48(this->target)) {
+    if (!INCREMENT_I) {
         this->Ireg--;
     }
     return;
@@ -789,15 +2046,85 @@ void tehCPUS::I_FX55_SAVE_REGISTERS(unsigned short int inst) {
  *   ber of registers equal to x.
  */
 
-void tehCPUS::I_FX65_LOAD_REGISTERS(unsigned short int inst) {
-    int tempX = this->bitN(inst, 2);
-    for (unsigned char i = 0; i <= tempX; i++) {
-        this->regFile[i] = this->bus->read_ram(this->Ireg);
-        this->Ireg++;
-    }
-        // Bug in CHIP48, SUPERCHIP10, SUPERCHIP 11, ireg off by one
-    if (IS_HP48(this->target)) {
+template<bool INCREMENT_I>
+void tehCPUS::I_FX65_LOAD_REGISTERS(const instruction& inst) {
+    int count = inst.X + 1;
+    this->bus->read_span(this->Ireg, this->regFile, count);
+    this->Ireg += count;
+    // Bug in CHIP48, SUPERCHIP10, SUPERCHIP 11, ireg off by one
+    if (!INCREMENT_I) {
         this->Ireg--;
     }
     return;
-}
\ No newline at end of file
+}
+
+/**
+ * XO-CHIP
+ * PLANE n - (0xFn01)
+ * 
+ * The plane mask sits where X normally would, so the decoder has already 
+ *   pulled it out for us. Every later draw, clear, and scroll only touches the
+ *   selected planes.
+ */
+
+void tehCPUS::I_FN01_SELECT_PLANES(const instruction& inst) {
+    this->bus->select_planes(inst.X);
+    return;
+}
+
+/**
+ * Fused pairs run both halves, exactly as they would have run apart. Each one
+ *   steps the PC over its first half itself, so the second half sees the same
+ *   PC it would have, and the usual increment afterwards steps over the second.
+ */
+
+template<bool DISPLAY_WAIT>
+void tehCPUS::F_ANNN_DXYN_LOAD_AND_DRAW(const instruction& inst) {
+    this->fusion_counts[FUSE_LOAD_AND_DRAW]++;
+    this->Ireg = inst.NNN;
+    this->PC = this->PC + 2;
+    this->I_DXYN_DRAW<DISPLAY_WAIT>(inst);
+    return;
+}
+
+void tehCPUS::F_ANNN_FX1E_LOAD_AND_OFFSET(const instruction& inst) {
+    this->fusion_counts[FUSE_LOAD_AND_OFFSET]++;
+    this->Ireg = inst.NNN + this->regFile[inst.X];
+    this->PC = this->PC + 2;
+    return;
+}
+
+void tehCPUS::F_6XNN_6YNN_LOAD_PAIR(const instruction& inst) {
+    this->fusion_counts[FUSE_LOAD_PAIR]++;
+    this->regFile[inst.X] = inst.NN;
+    this->regFile[inst.Y] = inst.N;
+    this->PC = this->PC + 2;
+    return;
+}
+
+/**
+ * If the skip is taken, the jump never runs at all, and we have to let the
+ *   block know that only one instruction's worth of cycles was spent.
+ */
+
+void tehCPUS::F_3XNN_1NNN_JUMP_IF_NOT_EQUAL(const instruction& inst) {
+    this->fusion_counts[FUSE_SKIP_AND_JUMP]++;
+    if (this->regFile[inst.X] == inst.NN) {
+        this->PC = this->PC + this->skip_length(this->PC);
+        this->fused_skip = true;
+    } else {
+        this->PC = inst.NNN - 2;
+    }
+    return;
+}
+
+void tehCPUS::F_4XNN_1NNN_JUMP_IF_EQUAL(const instruction& inst) {
+    this->fusion_counts[FUSE_SKIP_AND_JUMP]++;
+    if (this->regFile[inst.X] != inst.NN) {
+        this->PC = this->PC + this->skip_length(this->PC);
+        this->fused_skip = true;
+    } else {
+        this->PC = inst.NNN - 2;
+    }
+    return;
+}
@@ -18,6 +18,7 @@
 
 #include "tehBUS.h"
 #include "tehCOMMONZ.h"
+#include "tehSNOOP.h"
 
 namespace chippy {
 /**
@@ -29,22 +30,167 @@ namespace chippy {
  *   devices can be accessed through the tehBUS class. All memory access occurs
  *   through this BUS class.
  * 
- * Instructions are fetched, decoded, and executed when clock_sys() is called.
- *   This should be called approximately 500 times a second. The clock_60hz() 
- *   function should likewise be called approximately 60 times a second. The
- *   timers can run for at most 4.25 seconds, so drift is not too much of a 
- *   concern.
+ * Every possible instruction is decoded once, when the processor is built, into
+ *   a table holding its operation and operands. Instructions are fetched, looked
+ *   up in that table, and executed when clock_sys() is called. Fetched
+ *   instructions are cached per address, and the cache is kept honest by
+ *   snooping every RAM write made through the bus. Batches of instructions are
+ *   best run with run(), which, depending on set_core(), either interprets
+ *   them, runs straight-line code as translated blocks, or uses threaded 
+ *   dispatch. While translating, a few common pairs of instructions are fused
+ *   into one. Either way, the processor should be clocked approximately 500 
+ *   times a second. The clock_60hz() function should likewise be called
+ *   approximately 60 times a second. The timers can run for at most 4.25 
+ *   seconds, so drift is not too much of a concern.
  * 
  * The halt() function is unimplemented, though the logic for handling the
  *   sprite drawing quirk provides a proof of concept for the idea. It may be
  *   best to refactor this to better expose that functionality.
  * 
- * I do plan on extending the emulator to optionally emulate different sets of
- *   quirks. Ultimately, though, simply emulating the original system is good 
- *   enough for my needs.
+ * Each quirk can be toggled on its own. Rather than testing for quirks every
+ *   time an instruction runs, the decoder picks the matching variant of each
+ *   handler once, when the decode table is built. The variants are templates,
+ *   so each one is compiled without any quirk tests at all.
  */
-class tehCPUS {
+class tehCPUS : public tehSNOOP {
 private:
+    /**
+     * @brief Every operation the processor knows how to execute.
+     * 
+     * The decoder maps every instruction word onto one of these, and execute()
+     *  maps each of these onto its handler. Instructions that behave differently
+     *  under some quirk get one operation per behaviour, so the choice is made
+     *  once, while decoding, and never while executing.
+     */
+    enum operation {
+        OP_UNKNOWN,
+        OP_0NNN_SYS,
+        OP_00CN_SCROLL_DOWN,
+        OP_00E0_CLS,
+        OP_00EE_RET,
+        OP_00FB_SCROLL_RIGHT,
+        OP_00FC_SCROLL_LEFT,
+        OP_00FE_DISABLE_HIRES,
+        OP_00FF_ENABLE_HIRES,
+        OP_1NNN_JMP,
+        OP_2NNN_CALL,
+        OP_3XNN_SKIP_IF_EQUAL,
+        OP_4XNN_SKIP_IF_NOT_EQUAL,
+        OP_5XY0_SKIP_IF_X_EQ_Y,
+        OP_5XY2_SAVE_RANGE,
+        OP_5XY3_LOAD_RANGE,
+        OP_6XNN_LOAD_NN_TO_X,
+        OP_7XNN_ADD_NN_TO_X,
+        OP_8XY0_COPY_X_TO_Y,
+        OP_8XY1_OR_X_WITH_Y,
+        OP_8XY1_OR_X_WITH_Y_KEEP_VF,
+        OP_8XY2_AND_X_WITH_Y,
+        OP_8XY2_AND_X_WITH_Y_KEEP_VF,
+        OP_8XY3_XOR_X_WITH_Y,
+        OP_8XY3_XOR_X_WITH_Y_KEEP_VF,
+        OP_8XY4_ADD_X_AND_Y,
+        OP_8XY5_SUB_Y_FROM_X,
+        OP_8XZ6_SHIFT_X_RIGHT,
+        OP_8XY6_SHIFT_Y_RIGHT,
+        OP_8XY7_SUB_X_FROM_Y,
+        OP_8XZE_SHIFT_X_LEFT,
+        OP_8XYE_SHIFT_Y_LEFT,
+        OP_9XY0_SKIP_IF_X_NE_Y,
+        OP_ANNN_LOAD_IREG,
+        OP_BNNN_JUMP_TO_OFFSET,
+        OP_BXNN_JUMP_TO_OFFSET,
+        OP_CXNN_RANDOM,
+        OP_DXYN_DRAW,
+        OP_DXYN_DRAW_NO_WAIT,
+        OP_EX9E_SKIP_IF_KEY,
+        OP_EXA1_SKIP_IF_NO_KEY,
+        OP_F000_LOAD_LONG_IREG,
+        OP_FX07_READ_DISPLAY_TIMER,
+        OP_FX0A_READ_KEY,
+        OP_FX15_SET_DISPLAY_TIMER,
+        OP_FX18_SET_SOUND_TIMER,
+        OP_FX1E_ADD_VX_TO_I,
+        OP_FX29_LOAD_HEX_SPRITE,
+        OP_FX33_SAVE_BCD_VALUE,
+        OP_FX55_SAVE_REGISTERS,
+        OP_FX55_SAVE_REGISTERS_HP48,
+        OP_FX65_LOAD_REGISTERS,
+        OP_FX65_LOAD_REGISTERS_HP48,
+        OP_FN01_SELECT_PLANES,
+        // Fused pairs. These only ever appear in translated blocks.
+        OP_ANNN_DXYN_LOAD_AND_DRAW,
+        OP_ANNN_DXYN_LOAD_AND_DRAW_NO_WAIT,
+        OP_ANNN_FX1E_LOAD_AND_OFFSET,
+        OP_6XNN_6YNN_LOAD_PAIR,
+        OP_3XNN_1NNN_JUMP_IF_NOT_EQUAL,
+        OP_4XNN_1NNN_JUMP_IF_EQUAL,
+        OP_COUNT
+    };
+
+    /**
+     * @brief A pre-decoded instruction.
+     * 
+     * Holds the operation to perform, and every operand field the handlers
+     *  might want, already extracted from the instruction word.
+     * 
+     * A fused pair takes whichever fields it needs from both instructions. 
+     *  6XNN+6YNN is the odd one out, and keeps its second value in N.
+     */
+    struct instruction {
+        unsigned char op; // An operation, stored small to keep the table small.
+        unsigned char X;
+        unsigned char Y;
+        unsigned char N;
+        unsigned char NN;
+        unsigned short int NNN;
+        unsigned short int raw; // The instruction, as it appears in memory.
+    };
+
+    // One entry per possible instruction word.
+    static const unsigned int DECODE_TABLE_SIZE = 0x10000;
+
+    // Every instruction word, decoded once for our quirks mode.
+    instruction *decode_table;
+
+    // One slot per address, even or odd.
+    static const unsigned int INSTRUCTION_CACHE_SIZE = 4096;
+    // Points into the decode table for the instruction at each address, or is
+    //  NULL if that address hasn't been fetched since it was last written to.
+    const instruction *instruction_cache[INSTRUCTION_CACHE_SIZE];
+
+    // The longest straight-line run we will translate into a single block.
+    static const unsigned int MAX_BLOCK_LENGTH = 32;
+
+    /**
+     * @brief A translated block of instructions.
+     * 
+     * A block is a straight-line run of decoded instructions, ending at the
+     *  first instruction that might change the flow of execution, wait on
+     *  something, or write to memory.
+     */
+    struct block {
+        bool valid; // False once any byte the block was built from is written.
+        unsigned short int start; // Address of the first instruction.
+        unsigned short int length; // Number of instructions in the block.
+        unsigned short int entries; // Number of entries in code, after fusing.
+        block *link; // The block that ran after this one, last time around.
+        instruction code[MAX_BLOCK_LENGTH];
+    };
+
+    // Translated blocks, by starting address. Allocated on first use.
+    block *block_table[INSTRUCTION_CACHE_SIZE];
+    // How many valid blocks were translated from each byte of RAM.
+    unsigned char block_coverage[INSTRUCTION_CACHE_SIZE];
+    // Set when a fused skip-and-jump skips its jump, so only half of it ran.
+    bool fused_skip;
+    // How many cycles the current call to run() was given.
+    int batch_cycles;
+    // How many cycles into the batch the current instruction is. The run_*()
+    //   loops keep this up to date for any handler that can change STreg.
+    int cycle_stamp;
+    // Whether the speaker was last told to beep.
+    bool sounding;
+
     std::default_random_engine generator;
     std::uniform_int_distribution<unsigned char> dist;
 
@@ -52,6 +198,12 @@ private:
 
     bool vblank_quirk_block;
     systype target;
+    // A bitset of chippy::quirk flags, used while decoding.
+    unsigned int quirks;
+    // Selects which of the run_*() loops run() uses.
+    coretype core;
+    // If true, run() fast-forwards through loops that can't change anything.
+    bool idle_skip;
     // If true, PC stops advancing. Instructions that set this to true should
     //   eventually resuem.
     bool haltPC; 
@@ -121,39 +273,171 @@ private:
     std::string build_unknown_instruction_error(unsigned short int inst);
 
 /**
- * @brief Decode, and execute an instruction.
+ * @brief Fetch the decoded instruction at the Program Counter.
+ * 
+ * Instructions are read from RAM the first time they're fetched, and served
+ *  from the instruction cache after that.
+ * 
+ * @return The pre-decoded instruction at this->PC.
+ */
+    const instruction* fetch();
+
+/**
+ * @brief Returns how far a skip at an address should move the PC.
+ * 
+ * On XO-CHIP, a skip over F000 NNNN has to step over both halves of it.
+ * 
+ * @param addr The address of the skip instruction.
+ * @return 4 if the next instruction is F000 on XO-CHIP, otherwise 2.
+ */
+    unsigned short int skip_length(unsigned short int addr);
+
+/**
+ * @brief Returns how many framebuffer pixels a scroll moves per screen pixel.
+ * 
+ * SUPERCHIP 1.1 always scrolls by framebuffer pixels, but XO-CHIP scrolls by
+ *  whole screen pixels, which are doubled in low resolution mode.
+ * 
+ * @return 2 on XO-CHIP in low resolution mode, otherwise 1.
+ */
+    int scroll_scale();
+
+/**
+ * @brief Empties the instruction cache.
+ */
+    void flush_instruction_cache();
+
+/**
+ * @brief Returns the translated block starting at the Program Counter.
+ * 
+ * If there is no valid block at this->PC yet, one is translated first.
+ * 
+ * @return The block starting at this->PC.
+ */
+    block* find_block();
+
+/**
+ * @brief Translates the instructions starting at an address into a block.
+ * 
+ * @param b The block to fill in.
+ * @param addr The address to start translating from.
+ */
+    void translate_block(block* b, unsigned short int addr);
+
+/**
+ * @brief Throws away every translated block built from a written address.
+ * 
+ * @param addr The address that was written to.
+ */
+    void invalidate_blocks(int addr);
+
+/**
+ * @brief Tests whether an operation must be the last one in a block.
+ * 
+ * @param op The operation to test.
+ * @return True if translation should stop after this operation.
+ */
+    bool ends_block(unsigned char op);
+
+/**
+ * @brief Tries to fuse a pair of instructions into a single one.
+ * 
+ * @param first The first instruction, which becomes the fused pair.
+ * @param second The instruction that follows it.
+ * @return True if the pair was fused.
+ */
+    bool fuse_instructions(instruction& first, const instruction& second);
+
+/**
+ * @brief Tests whether an operation can be part of an idle loop.
+ * 
+ * These only read registers, timers, keys, or memory, and can only change
+ *  registers, so running one twice from the same state does the same thing.
  * 
- * @param inst Instruction to decode and execute.
+ * @param op The operation to test.
+ * @return True if the operation may appear in an idle loop.
  */
-    void decode_and_execute(unsigned short int inst);
+    bool is_idle_safe(unsigned char op);
+
+/**
+ * @brief Decode an instruction, without executing it.
+ * 
+ * @param inst Instruction to decode.
+ * @return The pre-decoded instruction, with all of its fields extracted.
+ */
+    instruction decode(unsigned short int inst);
+
+/**
+ * @brief Fills the decode table with every possible instruction.
+ */
+    void build_decode_table();
+
+/**
+ * @brief Execute a pre-decoded instruction.
+ * 
+ * @param inst Instruction to execute.
+ */
+    void execute(const instruction& inst);
 
     // 0x0 Block
 /**
- * @brief Handles all 0x0XXX instructions.
+ * @brief Decodes all 0x0XXX instructions.
  * 
- * @param inst Instruction to decode and execute.
+ * @param inst Instruction to decode.
+ * @return The operation this instruction maps to.
  */
-    void decode_hex_0(unsigned short int inst);
+    operation decode_hex_0(unsigned short int inst);
+
+/**
+ * @brief Reports an unknown instruction.
+ * 
+ * @param inst Instruction to execute.
+ */
+    void I_UNKNOWN(const instruction& inst);
+
+/**
+ * @brief Calls a native machine code subroutine. Not emulated.
+ * 
+ * @param inst Instruction to execute.
+ */
+    void I_0NNN_SYS(const instruction& inst);
+
+/**
+ * @brief Scrolls the display down by N pixels in SUPERCHIP 1.1 targets.
+ * 
+ * @param inst Instruction to execute.
+ */
+    void I_00CN_SCROLL_DOWN(const instruction& inst);
 
 /**
  * @brief Clears the display.
  */
-    void I_00E0_CLS();
+    void I_00E0_CLS(const instruction& inst);
 
 /**
  * @brief Return from subroutine.
  */
-    void I_00EE_RET(); 
+    void I_00EE_RET(const instruction& inst); 
+
+/**
+ * @brief Scrolls the display right by 4 pixels in SUPERCHIP 1.1 targets.
+ */
+    void I_00FB_SCROLL_RIGHT(const instruction& inst);
+
+/**
+ * @brief Scrolls the display left by 4 pixels in SUPERCHIP 1.1 targets.
+ */
+    void I_00FC_SCROLL_LEFT(const instruction& inst);
 
 /**
  * @brief Disables hi-res drawing mode in SUPERCHIP targets.
  */
-    void I_00FE_DISABLE_HIRES();
+    void I_00FE_DISABLE_HIRES(const instruction& inst);
 
 /**
  * @brief Enables hi-res drawing mode in SUPERCHIP targets.
  */
-    void I_00FF_ENABLE_HIRES(); 
+    void I_00FF_ENABLE_HIRES(const instruction& inst); 
     
     // 0x1 Block
 
@@ -162,7 +446,7 @@ private:
  * 
  * @param inst Instruction to execute.
  */
-    void I_1NNN_JMP(unsigned short int inst);
+    void I_1NNN_JMP(const instruction& inst);
     
     // 0x2 Block
 
@@ -171,7 +455,7 @@ private:
  * 
  * @param inst Instruction to execute.
  */
-    void I_2NNN_CALL(unsigned short int inst);
+    void I_2NNN_CALL(const instruction& inst);
 
     // 0x3 Block
 
@@ -180,7 +464,7 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_3XNN_SKIP_IF_EQUAL(unsigned short int inst);
+    void I_3XNN_SKIP_IF_EQUAL(const instruction& inst);
    
     // 0x4 Block
 
@@ -189,7 +473,7 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_4XNN_SKIP_IF_NOT_EQUAL(unsigned short int inst);
+    void I_4XNN_SKIP_IF_NOT_EQUAL(const instruction& inst);
 
     // 0x5 Block
 
@@ -198,7 +482,21 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_5XY0_SKIP_IF_X_EQ_Y(unsigned short int inst);
+    void I_5XY0_SKIP_IF_X_EQ_Y(const instruction& inst);
+
+/**
+ * @brief Save Vx through Vy to memory starting at I, in XO-CHIP targets.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void I_5XY2_SAVE_RANGE(const instruction& inst);
+
+/**
+ * @brief Load Vx through Vy from memory starting at I, in XO-CHIP targets.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void I_5XY3_LOAD_RANGE(const instruction& inst);
 
     // 0x6 Block
     
@@ -207,7 +505,7 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_6XNN_LOAD_NN_TO_X(unsigned short int inst);
+    void I_6XNN_LOAD_NN_TO_X(const instruction& inst);
     
     // 0x7 Block
 
@@ -216,79 +514,90 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_7XNN_ADD_NN_TO_X(unsigned short int inst);
+    void I_7XNN_ADD_NN_TO_X(const instruction& inst);
     
     // 0x8 Block
 
 /**
- * @brief Handles all 0x8XXX instructions.
+ * @brief Decodes all 0x8XXX instructions.
  * 
- * @param inst Instruction to decode and execute. 
+ * @param inst Instruction to decode.
+ * @return The operation this instruction maps to.
  */
-    void decode_hex_8(unsigned short int inst);
+    operation decode_hex_8(unsigned short int inst);
 
 /**
  * @brief Copy the value in Vy to Vx.
  *  
  * @param inst Instruction to execute. 
  */
-    void I_8XY0_COPY_X_TO_Y(unsigned short int inst);
+    void I_8XY0_COPY_X_TO_Y(const instruction& inst);
 
 /**
  * @brief Perform a bitwise OR operation on Vx with Vy.
  * 
+ * @tparam RESET_VF If true, Vf is reset to zero afterwards.
  * @param inst Instruction to execute. 
  */
-    void I_8XY1_OR_X_WITH_Y(unsigned short int inst);
+    template<bool RESET_VF>
+    void I_8XY1_OR_X_WITH_Y(const instruction& inst);
 
 /**
  * @brief Perform a bitwise AND operation on Vx with Vy.
  * 
+ * @tparam RESET_VF If true, Vf is reset to zero afterwards.
  * @param inst Instruction to execute. 
  */
-    void I_8XY2_AND_X_WITH_Y(unsigned short int inst);
+    template<bool RESET_VF>
+    void I_8XY2_AND_X_WITH_Y(const instruction& inst);
 
 /**
  * @brief Perform a bitwise XOR operation on Vx with Vy.
  * 
+ * @tparam RESET_VF If true, Vf is reset to zero afterwards.
  * @param inst Instruction to execute. 
  */
-    void I_8XY3_XOR_X_WITH_Y(unsigned short int inst);
+    template<bool RESET_VF>
+    void I_8XY3_XOR_X_WITH_Y(const instruction& inst);
 
 /**
  * @brief Add the value in Vy to Vx - Store carry bit in Vf.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_8XY4_ADD_X_AND_Y(unsigned short int inst);
+    void I_8XY4_ADD_X_AND_Y(const instruction& inst);
 
 /**
  * @brief Subtract the value in Vy from Vx - Store borrow bit in Vf.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_8XY5_SUB_Y_FROM_X(unsigned short int inst);
+    void I_8XY5_SUB_Y_FROM_X(const instruction& inst);
 
 /**
  * @brief Shift the value in Vx right by one - Store LSB in Vf.
  * 
+ * @tparam SHIFT_VY If true, Vy is copied into Vx before shifting.
  * @param inst Instruction to execute. 
  */
-    void I_8XZ6_SHIFT_X_RIGHT(unsigned short int inst);
+    template<bool SHIFT_VY>
+    void I_8XZ6_SHIFT_X_RIGHT(const instruction& inst);
 
 /**
  * @brief Subtract the value in Vx from Vy - Store the borrow in Vf.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_8XY7_SUB_X_FROM_Y(unsigned short int inst);
+    void I_8XY7_SUB_X_FROM_Y(const instruction& inst);
 
 /**
  * @brief Shift the value in Vx left by one - Store MSB in Vf.
  * 
+ * @tparam SHIFT_VY If true, Vy is copied into Vx before shifting.
  * @param inst Instruction to execute. 
  */
-    void I_8XZE_SHIFT_X_LEFT(unsigned short int inst);
+    template<bool SHIFT_VY>
+    void I_8XZE_SHIFT_X_LEFT(const instruction& inst);
 
     // 0x9 Block
 
@@ -297,7 +606,7 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_9XY0_SKIP_IF_X_NE_Y(unsigned short int inst);
+    void I_9XY0_SKIP_IF_X_NE_Y(const instruction& inst);
 
     // 0xA Block
 
@@ -306,16 +615,18 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_ANNN_LOAD_IREG(unsigned short int inst);
+    void I_ANNN_LOAD_IREG(const instruction& inst);
     
     // 0xB Block
 
 /**
  * @brief Jump to the memory location in V0 + an offset 0xNNN.
  * 
+ * @tparam JUMP_VX If true, jump to Vx + 0xNN instead.
  * @param inst Instruction to execute. 
  */
-    void I_BNNN_JUMP_TO_OFFSET(unsigned short int inst);
+    template<bool JUMP_VX>
+    void I_BNNN_JUMP_TO_OFFSET(const instruction& inst);
     
     // 0xC Block
 
@@ -324,121 +635,243 @@ private:
  * 
  * @param inst Instruction to execute. 
  */
-    void I_CXNN_RANDOM(unsigned short int inst);
+    void I_CXNN_RANDOM(const instruction& inst);
 
     // 0xD Block
 /**
  * @brief Draw a sprite of length N at (X,Y).
  * 
+ * @tparam DISPLAY_WAIT If true, wait for the display refresh afterwards.
  * @param inst Instruction to execute. 
  */
-    void I_DXYN_DRAW(unsigned short int inst);
+    template<bool DISPLAY_WAIT>
+    void I_DXYN_DRAW(const instruction& inst);
 
     // 0xE Block
 
 /**
- * @brief Handles all 0xEXXX instructions.
+ * @brief Decodes all 0xEXXX instructions.
  * 
- * @param inst Instruction to decode and execute.
+ * @param inst Instruction to decode.
+ * @return The operation this instruction maps to.
  */
-    void decode_hex_E(unsigned short int inst);
+    operation decode_hex_E(unsigned short int inst);
 
 /**
  * @brief Skip if Key is Pressed.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_EX9E_SKIP_IF_KEY(unsigned short int inst);
+    void I_EX9E_SKIP_IF_KEY(const instruction& inst);
 
 /**
  * @brief Skip if Key Not Pressed.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_EXA1_SKIP_IF_NO_KEY(unsigned short int isnt);
+    void I_EXA1_SKIP_IF_NO_KEY(const instruction& inst);
 
     // 0xF Block
 
 /**
- * @brief Handles all 0xFXXX instructions.
+ * @brief Decodes all 0xFXXX instructions.
+ * 
+ * @param inst Instruction to decode.
+ * @return The operation this instruction maps to.
+ */
+    operation decode_hex_F(unsigned short int inst);
+
+/**
+ * @brief Load I with the 16 bit address that follows, in XO-CHIP targets.
  * 
- * @param inst Instruction to decode and execute.
+ * @param inst Instruction to execute. 
  */
-    void decode_hex_F(unsigned short int inst);
+    void I_F000_LOAD_LONG_IREG(const instruction& inst);
 
 /**
  * @brief Save the Delay Timer's current value into Vx.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX07_READ_DISPLAY_TIMER(unsigned short int inst);
+    void I_FX07_READ_DISPLAY_TIMER(const instruction& inst);
 
 /**
  * @brief Save the current key's scancode into the register Vx.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX0A_READ_KEY(unsigned short int inst);
+    void I_FX0A_READ_KEY(const instruction& inst);
 
 /**
  * @brief Load the value in Vx to the Delay Timer Register.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX15_SET_DISPLAY_TIMER(unsigned short int inst);
+    void I_FX15_SET_DISPLAY_TIMER(const instruction& inst);
 
 /**
  * @brief Load the value in Vx to the Sound Timer Register.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX18_SET_SOUND_TIMER(unsigned short int inst);
+    void I_FX18_SET_SOUND_TIMER(const instruction& inst);
 
 /**
  * @brief Add the value in Vx to I.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX1E_ADD_VX_TO_I(unsigned short int inst);
+    void I_FX1E_ADD_VX_TO_I(const instruction& inst);
 
 /**
  * @brief Load the memory location for the hex sprite of value in Vx.
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX29_LOAD_HEX_SPRITE(unsigned short int inst);
+    void I_FX29_LOAD_HEX_SPRITE(const instruction& inst);
 
 /**
  * @brief Save BCD representation of Vx into memory at I(+0-3).
  * 
  * @param inst Instruction to execute. 
  */
-    void I_FX33_SAVE_BCD_VALUE(unsigned short int inst);
+    void I_FX33_SAVE_BCD_VALUE(const instruction& inst);
 
 /**
  * @brief Save registers V0 through Vx to memory starting at I.
  * 
+ * @tparam INCREMENT_I If false, I is left one short of the end.
  * @param inst Instruction to execute. 
  */
-    void I_FX55_SAVE_REGISTERS(unsigned short int inst);
+    template<bool INCREMENT_I>
+    void I_FX55_SAVE_REGISTERS(const instruction& inst);
 
 /**
  * @brief Load registers V0 through Vx from memory starting at I.
  * 
+ * @tparam INCREMENT_I If false, I is left one short of the end.
+ * @param inst Instruction to execute. 
+ */
+    template<bool INCREMENT_I>
+    void I_FX65_LOAD_REGISTERS(const instruction& inst);
+
+/**
+ * @brief Select the planes drawn to in XO-CHIP targets, from the mask in n.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void I_FN01_SELECT_PLANES(const instruction& inst);
+
+/**
+ * @brief Load I with 0xNNN, and draw a sprite. Fused ANNN, DXYN.
+ * 
+ * @tparam DISPLAY_WAIT If true, wait for the display refresh afterwards.
+ * @param inst Instruction to execute. 
+ */
+    template<bool DISPLAY_WAIT>
+    void F_ANNN_DXYN_LOAD_AND_DRAW(const instruction& inst);
+
+/**
+ * @brief Load I with 0xNNN, and add Vx to it. Fused ANNN, FX1E.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void F_ANNN_FX1E_LOAD_AND_OFFSET(const instruction& inst);
+
+/**
+ * @brief Load Vx with 0xNN, and then Vy with a second value. Fused 6XNN, 6YNN.
+ * 
  * @param inst Instruction to execute. 
  */
-    void I_FX65_LOAD_REGISTERS(unsigned short int inst);
+    void F_6XNN_6YNN_LOAD_PAIR(const instruction& inst);
+
+/**
+ * @brief Jump to 0xNNN, unless Vx equals 0xNN. Fused 3XNN, 1NNN.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void F_3XNN_1NNN_JUMP_IF_NOT_EQUAL(const instruction& inst);
+
+/**
+ * @brief Jump to 0xNNN, if Vx equals 0xNN. Fused 4XNN, 1NNN.
+ * 
+ * @param inst Instruction to execute. 
+ */
+    void F_4XNN_1NNN_JUMP_IF_EQUAL(const instruction& inst);
+
+/**
+ * @brief Runs up to a number of cycles, one instruction at a time.
+ * 
+ * @param cycles The most cycles to run.
+ * @return The number of cycles that actually ran.
+ */
+    int run_interpreted(int cycles);
+
+/**
+ * @brief Runs up to a number of cycles through translated blocks.
+ * 
+ * Straight-line code runs out of translated blocks, rather than being fetched
+ *  one instruction at a time.
+ * 
+ * @param cycles The most cycles to run.
+ * @return The number of cycles that actually ran.
+ */
+    int run_translated(int cycles);
+
+/**
+ * @brief Runs up to a number of cycles through the threaded interpreter.
+ * 
+ * The registers are kept in locals for the whole batch, and each instruction
+ *  dispatches straight to the next.
+ * 
+ * @param cycles The most cycles to run.
+ * @return The number of cycles that actually ran.
+ */
+    int run_threaded(int cycles);
+
+/**
+ * @brief Runs up to a number of cycles, skipping over idle loops.
+ * 
+ * This interprets instructions one at a time, like run_interpreted(), but 
+ *  when a loop comes back around to a state it has already been in, the 
+ *  rest of its iterations are skipped, rather than run.
+ * 
+ * @param cycles The most cycles to run.
+ * @return The number of cycles that ran, or were skipped.
+ */
+    int run_skipping_idle(int cycles);
+
+public:
+    // The kinds of fused pairs we count.
+    enum fusion {
+        FUSE_LOAD_AND_DRAW, // ANNN, DXYN
+        FUSE_LOAD_AND_OFFSET, // ANNN, FX1E
+        FUSE_LOAD_PAIR, // 6XNN, 6YNN
+        FUSE_SKIP_AND_JUMP, // 3XNN or 4XNN, 1NNN
+        FUSION_COUNT
+    };
+
+private:
+    // How many times each kind of fused pair has run.
+    unsigned long int fusion_counts[FUSION_COUNT];
 
 public:
 
 /**
  * @brief Construct a new tehCPUS::tehCPUS object
  * 
- * Initializes registers, and RNG.
+ * Initializes registers, RNG, and the decode table.
  * 
  * @param bus pointer to the Chip8 bus object.
+ * @param opMode The current quirks mode.
+ * @param quirks A bitset of chippy::quirk flags to emulate.
  */
-    tehCPUS(tehBUS& bus, systype opMode);
+    tehCPUS(tehBUS& bus, systype opMode, unsigned int quirks);
+
+/**
+ * @brief Destroy the tehCPUS::tehCPUS object, and its decode table.
+ */
+    ~tehCPUS();
 
     // TODO: Once we have a proper interface, use these for the pause button.
     // void halt()
@@ -449,20 +882,87 @@ public:
  */
     void clock_sys();
 
+/**
+ * @brief Selects how run() executes instructions.
+ * 
+ * @param c The interpreter, translated blocks, or threaded code.
+ */
+    void set_core(coretype c);
+
+/**
+ * @brief Runs up to a number of cycles, in one call.
+ * 
+ * This has exactly the same effect as calling clock_sys() the same number of
+ *  times, except that it returns early once nothing more can happen until the
+ *  next display refresh, or the next key press. Exceptions are thrown exactly
+ *  as clock_sys() throws them.
+ * 
+ * @param cycles The most cycles to run.
+ * @return The number of cycles that actually ran.
+ */
+    int run(int cycles);
+
+/**
+ * @brief Toggles fast-forwarding through idle loops.
+ * 
+ * When enabled, run() always interprets, regardless of set_core(), so that it
+ *  can watch for idle loops. This is mostly useful for headless runs, where 
+ *  nobody is waiting on the wall clock.
+ * 
+ * @param mode If True, idle loops are skipped.
+ */
+    void set_idle_skip(bool mode);
+
+/**
+ * @brief Returns how many times a kind of fused pair has run.
+ * 
+ * Pairs are only fused in translated blocks, so this stays at zero for the 
+ *  other cores.
+ * 
+ * @param f The kind of fused pair.
+ * @return The number of times it has run.
+ */
+    unsigned long int get_fusion_count(fusion f);
+
+/**
+ * @brief Prints every register, the stack pointer, and both timers.
+ */
+    void report_state();
+
 /**
  * @brief Timer register clocks.
  */
     void clock_60hz();
 
 /**
- * @brief If STreg is true, tell the speaker to beep.
+ * @brief Tells the speaker whether to beep, depending on STreg.
+ * 
+ * Call this exactly once per frame, after clock_60hz(). Changes in between are
+ *  passed on as they happen, by sound_edge().
  */
     void set_sound();
 
+/**
+ * @brief Tells the speaker the sound timer has started, or stopped, mid-frame.
+ * 
+ * Nothing is sent unless the state actually changed.
+ * 
+ * @param on Whether the sound timer is now nonzero.
+ * @param cycle How many cycles into the batch the change happened.
+ */
+    void sound_edge(bool on, int cycle);
+
 /**
  * @brief Resets the processor.
  */
     void reset();
+
+/**
+ * @brief Drops any cached instruction that overlaps a written address.
+ * 
+ * @param addr The address that was written to.
+ */
+    void snoop_write(int addr);
 };
 }
 
@@ -3,19 +3,18 @@
 #include <stdexcept>
 #include <iostream>
 
-bool tehRAMS::validate_memory_access(unsigned int addr) {
-    return (addr < size) ? true : false;
-}
-
+/**
+ * Only powers of two are allowed, so that everything past the end of our RAM
+ *   lines up with the filler, and a 4KB machine sees the same thing at 0x1000
+ *   that it does at 0xF000.
+ */
 tehRAMS::tehRAMS(size_t s) : size(s) {
-    memory = new unsigned char[size];
+    if ((s == 0) || (s > MAX_SIZE) || ((s & (s - 1)) != 0)) {
+        throw std::out_of_range("RAM size must be a power of two, up to 64KB.");
+    } // else do_nothing();
     tehRAMS::clear_tehRAMS();
 }
 
-tehRAMS::~tehRAMS() {
-    delete[] memory;
-}
-
 /** TODO: We might want to init with different data. */
 void tehRAMS::clear_tehRAMS() {
     unsigned char data[80] = {
@@ -39,21 +38,57 @@ void tehRAMS::clear_tehRAMS() {
     for (unsigned int i = 0; i < 80; i++) {
         tehRAMS::write_ram(i, data[i]);
     }
-    for (unsigned int i = 0x200; i < size; i++) {
-        tehRAMS::write_ram(i, 0);
-    }
+    std::memset(&this->memory[80], 0, this->size - 80);
+    std::memset(&this->memory[this->size], 255, MAX_SIZE + 1 - this->size);
 }
 
-unsigned char tehRAMS::read_ram(unsigned int addr) {
-    return tehRAMS::validate_memory_access(addr) ? memory[addr] : 255;
+/**
+ * A span that runs off the end of the address space is copied in two pieces,
+ *   the second starting back at 0.
+ */
+void tehRAMS::read_span(unsigned int addr, unsigned char* data, size_t len) {
+#ifndef CHIPPY_CHECKED_RAM
+    size_t done = 0;
+    while (done < len) {
+        size_t index = (addr + done) & (MAX_SIZE - 1);
+        size_t run = MAX_SIZE - index;
+        run = (run < len - done) ? run : len - done;
+        std::memcpy(data + done, &this->memory[index], run);
+        done += run;
+    }
+#else
+    for (size_t i = 0; i < len; i++) {
+        data[i] = tehRAMS::read_ram(addr + i);
+    }
+#endif
+    return;
 }
 
-bool tehRAMS::write_ram(unsigned int addr, unsigned char val) {
+bool tehRAMS::write_span(unsigned int addr, const unsigned char* data, 
+                         size_t len) {
     bool fail = false;
-    if (tehRAMS::validate_memory_access(addr)) {
-        this->memory[addr] = val;
-    } else {
-        fail = true;
+#ifndef CHIPPY_CHECKED_RAM
+    size_t done = 0;
+    while (done < len) {
+        size_t index = (addr + done) & (MAX_SIZE - 1);
+        size_t run = MAX_SIZE - index;
+        size_t valid = 0;
+        run = (run < len - done) ? run : len - done;
+        if (index < this->size) {
+            valid = (run < this->size - index) ? run : this->size - index;
+            std::memcpy(&this->memory[index], data + done, valid);
+        } // else, do_nothing();
+        fail = fail || (valid != run);
+        done += run;
+    }
+#else
+    for (size_t i = 0; i < len; i++) {
+        fail = tehRAMS::write_ram(addr + i, data[i]) || fail;
     }
+#endif
     return fail;
+}
+
+size_t tehRAMS::get_size() {
+    return this->size;
 }
\ No newline at end of file
@@ -15,11 +15,19 @@
  * @brief A class for handling emulation of a Chip-8's System Memory.
  */
 class tehRAMS {
+public:
+    /** The most memory any system can address, a full 16 bit address space. */
+    static const size_t MAX_SIZE = 0x10000;
+
 private:
-    /** Pointer to our memory array.*/
-    unsigned char *memory;
-    /** Size of our memory array. */
+    /** Size of our memory array, not counting the spare byte. */
     size_t size;
+    /** 
+     * Our memory array. It is always MAX_SIZE bytes, plus one spare byte at
+     *  the end, no matter how much memory the system has. Everything from
+     *  size onwards holds 255, and is never written to.
+     */
+    unsigned char memory[MAX_SIZE + 1];
 
     /**
      * @brief Verifies requested memory address is reachable
@@ -33,6 +41,18 @@ private:
      */
     bool validate_memory_access(unsigned int addr);
 
+    /**
+     * @brief Maps an address onto an index we may write to.
+     * 
+     * Valid addresses map onto themselves, once they have been masked down
+     *  to 16 bits, and everything else maps onto the spare byte at the end.
+     *  This is done by masking, rather than branching.
+     * 
+     * @param addr The address to map.
+     * @return An index that is always safe to write to.
+     */
+    size_t map_address(unsigned int addr);
+
     /**
      * @brief Resets system memory to a clean state.
      * 
@@ -46,19 +66,18 @@ public:
     /**
      * @brief Initializes the RAM file.
      * 
-     * @param size How many bytes to allocate for our system RAM.
+     * Anything up to 64KB may be used, so long as it's a power of two; XO-CHIP
+     *  uses all of it.
+     * 
+     * @param size How many bytes of system RAM to provide.
      */
     tehRAMS(size_t size = 4096);
 
-    /**
-     * @brief Safely destructs our ramfile.
-     */
-    ~tehRAMS();
-
     /** 
      * @brief Reads a byte from the RAM file.
      * 
-     * In the case that the given address is invalid, we default to simply
+     * Addresses wrap around at 64KB, like a 16 bit address bus. In the case
+     *  that the given address is past the end of our RAM, we default to simply
      *  returning all 1's (255, 0xFF).
      * 
      * @param addr The address we will read from.
@@ -69,11 +88,130 @@ public:
     /**
      * @brief Writes a byte to the RAM file.
      * 
+     * Addresses wrap around at 64KB, just as they do for read_ram().
+     * 
      * @param addr The address we will write to.
      * @param val The data we will write.
      * @return False (0) if the write succeeds, otherwise True (1).
      */
     bool write_ram(unsigned int addr, unsigned char val);
+
+    /**
+     * @brief Reads a run of bytes from the RAM file, in one go.
+     * 
+     * Addresses wrap, and bytes past the end of RAM read as 255, just as they
+     *  do from read_ram().
+     * 
+     * @param addr The address we will start reading from.
+     * @param data Where to copy the bytes to.
+     * @param len The number of bytes to read.
+     */
+    void read_span(unsigned int addr, unsigned char* data, size_t len);
+
+    /**
+     * @brief Returns a pointer to a run of bytes in the RAM file.
+     * 
+     * If the run fits below 64KB, the pointer points straight into our memory
+     *  array, and nothing is copied. Otherwise, the run is copied into spill
+     *  with read_span(), and spill is returned instead.
+     * 
+     * @param addr The address the run starts at.
+     * @param len The number of bytes in the run.
+     * @param spill Somewhere to copy the run to, at least len bytes long.
+     * @return A pointer to len bytes, read as they would be by read_ram().
+     */
+    const unsigned char* view_span(unsigned int addr, size_t len, 
+                                   unsigned char* spill);
+
+    /**
+     * @brief Writes a run of bytes to the RAM file, in one go.
+     * 
+     * Addresses wrap, and bytes past the end of RAM are dropped, just as they
+     *  are by write_ram().
+     * 
+     * @param addr The address we will start writing to.
+     * @param data The bytes to write.
+     * @param len The number of bytes to write.
+     * @return False (0) if every byte was written, otherwise True (1).
+     */
+    bool write_span(unsigned int addr, const unsigned char* data, size_t len);
+
+    /**
+     * @brief Returns the size of the RAM file.
+     * 
+     * @return The number of addressable bytes.
+     */
+    size_t get_size();
 };
 
+/**
+ * The accessors below are called for every fetch, and every byte an instruction
+ *   touches, so they live here where they can be inlined into tehBUS, and from
+ *   there into tehCPUS.
+ * 
+ * Define CHIPPY_CHECKED_RAM to go back to checking every address against the
+ *   size of our RAM, with a compare and branch, instead of wrapping at 64KB.
+ */
+inline bool tehRAMS::validate_memory_access(unsigned int addr) {
+    return (addr < size) ? true : false;
+}
+
+/**
+ * The comparison gives us 1, or 0, and negating that gives us a mask of all 1s,
+ *   or all 0s, to pick between the address, and the spare byte, with.
+ */
+inline size_t tehRAMS::map_address(unsigned int addr) {
+    size_t masked = addr & (MAX_SIZE - 1);
+    size_t valid = -((size_t) (masked < size));
+    return (masked & valid) | (MAX_SIZE & ~valid);
+}
+
+/**
+ * This is the one place a run is checked against the end of the address space.
+ */
+inline const unsigned char* tehRAMS::view_span(unsigned int addr, size_t len,
+                                               unsigned char* spill) {
+    const unsigned char* result = spill;
+    if (addr + len <= MAX_SIZE) {
+        result = &this->memory[addr];
+    } else {
+        tehRAMS::read_span(addr, spill, len);
+    }
+    return result;
+}
+
+#ifndef CHIPPY_CHECKED_RAM
+/**
+ * Everything between the end of our RAM, and MAX_SIZE, reads back as 255, so
+ *   masking the address down to 16 bits is all a read needs.
+ */
+inline unsigned char tehRAMS::read_ram(unsigned int addr) {
+    return this->memory[addr & (MAX_SIZE - 1)];
+}
+
+/**
+ * A write to an invalid address lands in the spare byte, which nothing ever
+ *   reads.
+ */
+inline bool tehRAMS::write_ram(unsigned int addr, unsigned char val) {
+    size_t index = this->map_address(addr);
+    this->memory[index] = val;
+    return index == MAX_SIZE;
+}
+#else
+inline unsigned char tehRAMS::read_ram(unsigned int addr) {
+    return tehRAMS::validate_memory_access(addr) ? memory[addr] : 255;
+}
+
+inline bool tehRAMS::write_ram(unsigned int addr, unsigned char val) {
+    bool fail = false;
+    if (tehRAMS::validate_memory_access(addr)) {
+        this->memory[addr] = val;
+    } else {
+        fail = true;
+    }
+    return fail;
+}
+#endif
+
 #endif
\ No newline at end of file
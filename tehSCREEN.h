@@ -2,13 +2,15 @@
  * @file tehSCREEN.h
  * @author William Tradewell
  * @brief A virtual interface for displaying screen data.
- * @version 0.2
- * @date 2026-03-27
+ * @version 0.5
+ * @date 2026-10-17
  */
 
 #ifndef TEHSCREEN_H_
 #define TEHSCREEN_H_
 
+#include <cstdint>
+
 /**
  * @brief tehSCREEN is a virtual interface for displaying screen data
  * 
@@ -22,19 +24,62 @@ public:
     virtual ~tehSCREEN() {}
 
 /**
- * @brief Copies screen data from framebuffer to display surface.
+ * @brief Copies packed screen data from framebuffer to display surface.
  * 
- * Screen data is stored in a boolean array, with false being black, and true
- *  being white. A given implementation should ensure that the size of the data
- *  matches the product of the horizontal and vertical resolutions.
+ * Screen data is stored one bit per pixel, in rows of 64 bit words, with the
+ *  leftmost pixel of each word in its most significant bit. Rows are always a
+ *  whole number of words, so the horizontal resolution must be a multiple of
+ *  64. This lets an implementation upload monochrome data without anyone 
+ *  having to expand it into pixels first.
  * 
- * @param data Pointer to beginning of screen data.
- * @param size Length of the screen data.
+ * @param data Pointer to beginning of packed screen data.
+ * @param size Length of the screen data, in words.
  */
-    virtual void copy_screen(bool* data, int size) = 0;
+    virtual void copy_screen(const uint64_t* data, int size) = 0;
+
+/**
+ * @brief Copies some rows of packed screen data to display surface.
+ * 
+ * This works just like copy_screen(), except that only the given rows are
+ *  read. Every other row is assumed to be unchanged since it was last copied.
+ * 
+ * @param data Pointer to beginning of packed screen data, not of the first row.
+ * @param first The first row to copy.
+ * @param count The number of rows to copy.
+ */
+    virtual void copy_rows(const uint64_t* data, int first, int count) = 0;
+
+/**
+ * @brief Copies some rows of several planes of packed screen data at once.
+ * 
+ * Each plane is laid out just like the copy_screen() data. Together,
+ *  the planes make up one color index per pixel, with the first plane in bit 0,
+ *  so two planes give four colors. Handing over every plane at once lets an
+ *  implementation compose them in a single pass.
+ * 
+ * @param planes Pointers to the beginning of each plane, not of the first row.
+ * @param plane_count The number of planes.
+ * @param first The first row to copy.
+ * @param count The number of rows to copy.
+ */
+    virtual void copy_planes(const uint64_t* const* planes, int plane_count, 
+                             int first, int count) = 0;
+
+/**
+ * @brief Sets the number of planes the screen is made of.
+ * 
+ * This is called before set_resolution(), so the display surface can be built
+ *  to suit.
+ * 
+ * @param count The number of planes.
+ */
+    virtual void set_planes(int count) = 0;
 
 /**
  * @brief Updates the renderer, and presents it.
+ * 
+ * Only the rows copied since the last refresh need to be sent to the display.
+ *  If nothing was copied at all, the display can simply be presented again.
  */
     virtual void refresh_screen() = 0;
 
@@ -0,0 +1,32 @@
+/**
+ * @file tehSNOOP.h
+ * @author William Tradewell
+ * @brief A virtual interface for watching writes on the system bus.
+ * @version 0.1
+ * @date 2026-10-17
+ */
+
+#ifndef TEHSNOOP_H_
+#define TEHSNOOP_H_
+
+/**
+ * @brief tehSNOOP is a virtual interface for watching memory writes.
+ * 
+ * Anything that keeps its own copy of data derived from system memory, like
+ *  the processor's decoded instruction cache, can implement this interface, and
+ *  attach itself to the bus. The bus will then tell it about every write, so
+ *  that it can throw away anything that has gone stale.
+ */
+class tehSNOOP {
+public:
+    virtual ~tehSNOOP() {}
+
+/**
+ * @brief Called after a byte of system memory has been written to.
+ * 
+ * @param addr The address that was written to.
+ */
+    virtual void snoop_write(int addr) = 0;
+};
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file tehTONE.h
+ * @author William Tradewell
+ * @brief A virtual interface for anything that generates audio on demand.
+ * @version 0.1
+ * @date 2026-10-17
+ */
+
+#ifndef TEHTONE_H_
+#define TEHTONE_H_
+
+#include <cstdint>
+
+/**
+ * @brief tehTONE is a virtual interface for generating audio on demand.
+ * 
+ * Rather than pushing audio at the speaker, the emulator hands a tehTONE to its
+ *  tehBEEP, and the speaker asks it for samples whenever it runs low. This is
+ *  usually from the audio device's own thread, so implementations must not 
+ *  share anything with the emulator that isn't safe to read across threads.
+ */
+class tehTONE {
+public:
+    virtual ~tehTONE() {}
+
+/**
+ * @brief Fills a buffer with audio.
+ * 
+ * Samples are signed, 16 bit, and interleaved, with one value per channel.
+ * 
+ * @param data Where to write the samples.
+ * @param count The number of samples to write, per channel.
+ */
+    virtual void generate_samples(int16_t* data, int count) = 0;
+};
+
+#endif
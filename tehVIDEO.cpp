@@ -9,7 +9,8 @@ tehVIDEO::tehVIDEO(tehSCREEN& s, chippy::systype sys) {
     this->fb_width = 64;
 
     this->init_pixel_array();
-    this->pixel_doubling = (this->system == chippy::SUPERCHIP10) ? true : false;
+    this->pixel_doubling = IS_SUPERCHIP(this->system);
+    this->clipping = true;
 }
 
 tehVIDEO::~tehVIDEO() {
@@ -28,6 +29,8 @@ void tehVIDEO::init_pixel_array() {
             this->fb_width = 64;
             break;
         case chippy::SUPERCHIP10:
+        case chippy::SUPERCHIP11:
+        case chippy::XOCHIP:
             this->fb_height = 64;
             this->fb_width = 128;
             break;
@@ -36,52 +39,93 @@ void tehVIDEO::init_pixel_array() {
             this->fb_width = 64;
             break;
     }
+    this->plane_count = (this->system == chippy::XOCHIP) ? chippy::MAX_PLANES : 1;
+    this->screen->set_planes(this->plane_count);
     this->screen->set_resolution(this->fb_width, this->fb_height);
     this->fb_size = sizeof(bool) * this->fb_height * this->fb_width;
+    this->fb_words = this->fb_width / 64;
+    for (int p = 0; p < chippy::MAX_PLANES; p++) {
+        if (p < this->plane_count) {
+            this->vram[p] = (uint64_t*) malloc(
+                sizeof(uint64_t) * this->fb_height * this->fb_words);
+        } else {
+            this->vram[p] = nullptr;
+        }
+    }
     this->pixel_array = (bool*) malloc(this->fb_size);
+    // Blank every plane, but only draw to the first until told otherwise.
+    this->plane_mask = (1 << this->plane_count) - 1;
     this->blank_screen(); // IMMEDIATELY init values
+    this->plane_mask = 0x1;
+    this->unpack_rows(0, this->fb_height);
     return;
 }
 
 void tehVIDEO::delete_pixel_array() {
+    for (int p = 0; p < chippy::MAX_PLANES; p++) {
+        free(this->vram[p]);
+        this->vram[p] = nullptr;
+    }
     free(this->pixel_array);
     this->pixel_array = nullptr;
     return;
 }
 
 void tehVIDEO::blank_screen() {
-    for (int i = 0; i < this->fb_size; i++) {
-        this->pixel_array[i] = false;
+    for (int p = 0; p < this->plane_count; p++) {
+        if ((this->plane_mask >> p) & 0x1) {
+            std::memset(this->vram[p], 0, 
+                sizeof(uint64_t) * this->fb_height * this->fb_words);
+        } // else, do_nothing();
     }
+    this->dirty_rows = ~((uint64_t) 0);
     return;
 }
 
-bool tehVIDEO::draw_byte(int x, int y, unsigned char byte) {
-    bool flipped = false;
-    int shift = 7;
-    // read in the byte
-    // Then iterate over the line, until there are no more high bits
-        // If the highest bit is high, then it is part of the sprite
-    shift = 7;
-    while (shift >= 0) {
-        if (byte & 0x1) { 
-            if (this->draw_point(x + shift, y)) {
-                flipped = true;
-            }
-        }
+void tehVIDEO::select_planes(int mask) {
+    this->plane_mask = mask & ((1 << this->plane_count) - 1);
+    return;
+}
 
-        shift--;
-        byte = byte >> 1;
+int tehVIDEO::get_selected_planes() {
+    int count = 0;
+    for (int p = 0; p < this->plane_count; p++) {
+        if ((this->plane_mask >> p) & 0x1) {
+            count++;
+        } // else, do_nothing();
     }
-    return flipped;
+    return count;
 }
 
-// Why x + 6 - shift, when shift gets up to 7?
-// x = 0. +6 = 6. 6-0 = 6. 6-1=5. 6-2=4. 6-3=3. 6-4=2. 6-5=1. 6-6=0.
-// ... *OH WAIT*. len is variable. Duh.
-// I was accidentally hardcoding the correct solution for a single case.
-bool tehVIDEO::draw_sprite(int x, int y, int size, unsigned char (&memory)[32]) {
-    bool flipped = false;
+/**
+ * Each row of the sprite is counted once if it collided with anything, no 
+ *   matter how many pixels it flipped, or how many framebuffer rows it covers
+ *   when pixel doubling. SUPERCHIP 1.1 also counts rows clipped off the bottom
+ *   of the screen, but only in hi-res mode.
+ *
+ * With more than one plane selected, XO-CHIP draws the same sprite into each of
+ *   them in turn, lowest plane first, reading the next sprite's worth of data
+ *   each time.
+ */
+int tehVIDEO::draw_sprite(int x, int y, int size, 
+                          const unsigned char *memory) {
+    int rows = 0;
+    int length = (size == 16 && IS_SUPERCHIP(this->system)) ? 32 : size;
+    int offset = 0;
+    for (int p = 0; p < this->plane_count; p++) {
+        if ((this->plane_mask >> p) & 0x1) {
+            rows += this->draw_plane(p, x, y, size, &memory[offset]);
+            offset += length;
+        } // else, do_nothing();
+    }
+    return rows;
+}
+
+int tehVIDEO::draw_plane(int plane, int x, int y, int size, 
+                         const unsigned char *memory) {
+    int rows = 0;
+    bool count_clipped = (this->system == chippy::SUPERCHIP11) 
+                      && !this->pixel_doubling && this->clipping;
     
     // If pixel doubling is in effect, set scaling factor.
     int scaling = this->pixel_doubling ? 2 : 1;
@@ -93,112 +137,133 @@ bool tehVIDEO::draw_sprite(int x, int y, int size, unsigned char (&memory)[32])
     int xpos = this->apply_wrapping_logic(x, width);
     int ypos = this->apply_wrapping_logic(y, height);
 
-    // if size is 16 AND we are in SUPERCHIP quirks mode
-    if (size == 16 && IS_SUPERCHIP(this->system)) {
-        for (int i = 0; i < size * 2; i += 2) {
-            if (this->draw_byte(xpos, ypos + (i / 2), memory[i])) {
-                flipped = true;
-            }
+    // if size is 16 AND we are in SUPERCHIP quirks mode, rows are 16 bits wide
+    bool wide = (size == 16 && IS_SUPERCHIP(this->system));
+    int bits = wide ? 16 : 8;
 
-            if (this->draw_byte(xpos + 8, ypos + (i / 2), memory[i + 1])) {
-                flipped = true;
-            }
+    for (int i = 0; i < size; i++) {
+        uint64_t row = 0;
+        if (wide) {
+            row = (memory[i * 2] << 8) | memory[(i * 2) + 1];
+        } else {
+            row = memory[i];
         }
-    } else {
-        for (int i = 0; i < size; i++) {
-            if (this->draw_byte(xpos, ypos + i, memory[i])) {
-                flipped = true;
+
+        bool hit = false;
+        if (this->pixel_doubling) {
+            uint64_t pattern = this->spread_bits(row) << (64 - (bits * 2));
+            if (this->draw_row(plane, xpos * 2, (ypos + i) * 2, pattern)) {
+                hit = true;
+            }
+            if (this->draw_row(plane, xpos * 2, ((ypos + i) * 2) + 1, pattern)) {
+                hit = true;
+            }
+        } else {
+            if (this->draw_row(plane, xpos, ypos + i, row << (64 - bits))) {
+                hit = true;
             }
         }
+
+        if (hit || (count_clipped && ypos + i > height - 1)) {
+            rows++;
+        } // else, do_nothing();
     }
 
-    return flipped;
+    return rows;
 }
 
 /**
- * @brief XOR one pixel, and return whether any white pixels were flipped.
+ * @brief XOR one row of a sprite, and return whether any white pixels flipped.
  * 
  * The coordinate plane starts at the top left corner. X increases to the right
- *   and Y increases downwards. To evaluate a given pixel, the coordinates must
- *   be converted into an array index. This pixel offset can be found by mult-
- *   iplying the Y-coordinate by the number of pixels per row- And then adding
- *   to that the value of the X-coordinate. More specifically, for the classic
- *   display mode, this works out to (y * 64) + x.
+ *   and Y increases downwards. Every row of the screen is packed into one or
+ *   two 64 bit words, with the leftmost pixel of each word in its most 
+ *   significant bit. So, pixel X of a row lives in word (x / 64), at bit
+ *   (63 - (x % 64)).
  * 
- * Then, we test the value of the pixel in that address. If it is all hi- Then 
- *   we need to set our return variable to true, and flip it to black. Otherwise,
- *   we set the pixel to white. We do not have, or need, logic to explicitly set
- *   a pixel to black.
- * 
- * NOTICE:
- * 
- * This effect seems to misbehave on MacOS. Looking into it further. It looks 
- *   like textures are being blitted to the render texture out of order. This 
- *   leads to a rather jarring jittering effect, displaying screen data that can 
- *   be several seconds old.
-
+ * A sprite row is at most 32 pixels wide, even doubled, so it can straddle at
+ *   most two words. We shift it into place in each, test for any white pixels
+ *   with an AND, and then flip them all with an XOR. We do not have, or need,
+ *   logic to explicitly set a pixel to black.
+ *
+ * @param plane - Plane to draw to
  * @param x - X coordinate
  * @param y  - Y coordinate
+ * @param pattern - Sprite row, starting from the most significant bit.
  * @return true - White pixel was flipped
  * @return false - White pixel was not flipped.
  */
-bool tehVIDEO::draw_point(int x, int y) {
-    bool flipped = false;
-    if (this->pixel_doubling) {
-        flipped = this->draw_double_point(x, y);
-    } else {
-        flipped = this->draw_single_point(x, y);
-    }
-    return flipped;
-}
-
-bool tehVIDEO::draw_single_point(int x, int y) {
+bool tehVIDEO::draw_row(int plane, int x, int y, uint64_t pattern) {
     bool flipped = false;
-    int xpos = x;
     int ypos = y;
 
     // Clip_wrap will set coords to -1 if clipping is on. In such cases, do not
-    // draw the pixel.
-    if (xpos > this->fb_width - 1) {
-        xpos = this->apply_clipping_logic(xpos, this->fb_width);
-    }
-
-    if (y > this->fb_height - 1) {
+    // draw the row.
+    if (ypos > this->fb_height - 1) {
         ypos = this->apply_clipping_logic(ypos, this->fb_height);
     }
 
-    if ((xpos > -1) && (ypos > -1)) { 
-        int pixel_offset = (ypos * this->fb_width) + xpos;
-        if (this->pixel_array[pixel_offset] == true) {
-            this->pixel_array[pixel_offset] = false;
+    if (ypos > -1) {
+        uint64_t *row = &this->vram[plane][ypos * this->fb_words];
+        if (pattern != 0) {
+            this->dirty_rows |= ((uint64_t) 1) << ypos;
+        } // else, do_nothing();
+        int word = x / 64;
+        int offset = x % 64;
+        if (this->draw_word(row, word, pattern >> offset)) {
             flipped = true;
-        } else {
-            this->pixel_array[pixel_offset] = true;
         }
+        if (offset != 0) {
+            if (this->draw_word(row, word + 1, pattern << (64 - offset))) {
+                flipped = true;
+            }
+        } // else, do_nothing();
     } // else, do_nothing();
     return flipped;
 }
 
-
-/**
- * @brief pixel doubler.
- */
-bool tehVIDEO::draw_double_point(int x, int y) {
+bool tehVIDEO::draw_word(uint64_t *row, int word, uint64_t bits) {
     bool flipped = false;
-    int bigx = x * 2;
-    int bigy = y * 2;
-    // I could make this a loop, but why would I?
-    bool pixel_one = draw_single_point(bigx, bigy);
-    bool pixel_two = draw_single_point(bigx + 1, bigy);
-    bool pixel_three = draw_single_point(bigx, bigy + 1);
-    bool pixel_four = draw_single_point(bigx + 1, bigy + 1);
-
-    if (pixel_one || pixel_two || pixel_three || pixel_four) {
-        flipped = true;
+    int index = word;
+
+    // Sprites start no further right than the edge of the screen, so a word 
+    // past the end of the row can only ever wrap back to the start.
+    if (index > this->fb_words - 1) {
+        index = this->clipping ? -1 : index - this->fb_words;
     }
+
+    if (index > -1 && bits != 0) {
+        flipped = (row[index] & bits) != 0;
+        row[index] ^= bits;
+    } // else, do_nothing();
     return flipped;
 }
 
+uint64_t tehVIDEO::spread_bits(uint64_t bits) {
+    // Move each bit n into bit 2n, a byte, then a nibble, and so on at a time.
+    uint64_t result = bits & 0xFFFF;
+    result = (result | (result << 8)) & 0x00FF00FF;
+    result = (result | (result << 4)) & 0x0F0F0F0F;
+    result = (result | (result << 2)) & 0x33333333;
+    result = (result | (result << 1)) & 0x55555555;
+    // And then copy it into bit 2n + 1.
+    return result | (result << 1);
+}
+
+void tehVIDEO::unpack_rows(int first, int count) {
+    for (int y = first; y < first + count; y++) {
+        for (int x = 0; x < this->fb_width; x++) {
+            uint64_t word = 0;
+            for (int p = 0; p < this->plane_count; p++) {
+                word |= this->vram[p][(y * this->fb_words) + (x / 64)];
+            }
+            this->pixel_array[(y * this->fb_width) + x] 
+                = ((word >> (63 - (x % 64))) & 0x1) != 0;
+        }
+    }
+    return;
+}
+
 int tehVIDEO::apply_wrapping_logic(int value, int edge) {
     int result = 0;
     if (value > edge) {
@@ -211,7 +276,7 @@ int tehVIDEO::apply_wrapping_logic(int value, int edge) {
 
 int tehVIDEO::apply_clipping_logic(int value, int edge) {
     int result = 0;
-    if (false) {
+    if (!this->clipping) {
         result = value % edge;
     } else {
         result = -1;
@@ -226,15 +291,128 @@ void tehVIDEO::set_video_mode(bool mode) {
 
 bool tehVIDEO::get_video_mode() {
     return this->pixel_doubling;
+}
+
+void tehVIDEO::set_clipping(bool mode) {
+    this->clipping = mode;
+    return;
 }   
 
+/**
+ * Rows are stored top to bottom, so scrolling down is one memmove of every row
+ *   that survives, towards the end of the plane, and then blanking the rows 
+ *   left at the top. Everything that moved is now dirty. Only the selected
+ *   planes scroll.
+ */
+void tehVIDEO::scroll_down(int n) {
+    int rows = (n < this->fb_height) ? n : this->fb_height;
+    if (rows > 0) {
+        int kept = (this->fb_height - rows) * this->fb_words;
+        for (int p = 0; p < this->plane_count; p++) {
+            if ((this->plane_mask >> p) & 0x1) {
+                uint64_t *plane = this->vram[p];
+                std::memmove(&plane[rows * this->fb_words], plane,
+                    sizeof(uint64_t) * kept);
+                std::memset(plane, 0, 
+                    sizeof(uint64_t) * rows * this->fb_words);
+            } // else, do_nothing();
+        }
+        this->dirty_rows = ~((uint64_t) 0);
+    } // else, do_nothing();
+    return;
+}
+
+/**
+ * The leftmost pixel of every word is its most significant bit, so moving 
+ *   pixels right is a right shift. The bits shifted out of each word are
+ *   carried into the next word along, so we work from the right end of the row
+ *   back towards the left, where zeroes are shifted in.
+ */
+void tehVIDEO::scroll_right(int n) {
+    if (n > 0 && n < 64) {
+        for (int p = 0; p < this->plane_count; p++) {
+            if ((this->plane_mask >> p) & 0x1) {
+                for (int y = 0; y < this->fb_height; y++) {
+                    uint64_t *row = &this->vram[p][y * this->fb_words];
+                    for (int w = this->fb_words - 1; w > 0; w--) {
+                        row[w] = (row[w] >> n) | (row[w - 1] << (64 - n));
+                    }
+                    row[0] >>= n;
+                }
+            } // else, do_nothing();
+        }
+        this->dirty_rows = ~((uint64_t) 0);
+    } // else, do_nothing();
+    return;
+}
+
+void tehVIDEO::scroll_left(int n) {
+    if (n > 0 && n < 64) {
+        for (int p = 0; p < this->plane_count; p++) {
+            if ((this->plane_mask >> p) & 0x1) {
+                for (int y = 0; y < this->fb_height; y++) {
+                    uint64_t *row = &this->vram[p][y * this->fb_words];
+                    for (int w = 0; w < this->fb_words - 1; w++) {
+                        row[w] = (row[w] << n) | (row[w + 1] >> (64 - n));
+                    }
+                    row[this->fb_words - 1] <<= n;
+                }
+            } // else, do_nothing();
+        }
+        this->dirty_rows = ~((uint64_t) 0);
+    } // else, do_nothing();
+    return;
+}
+
+/**
+ * Each run of consecutive dirty rows is copied in one go, with every plane at
+ *   once if there's more than one. If no rows are dirty, then the screen is 
+ *   just refreshed.
+ */
+
 void tehVIDEO::update_screen() {
-    this->screen->copy_screen(this->pixel_array, this->fb_size);
+    int y = 0;
+    while (this->dirty_rows != 0 && y < this->fb_height) {
+        if ((this->dirty_rows >> y) & 0x1) {
+            int first = y;
+            while (y < this->fb_height && ((this->dirty_rows >> y) & 0x1)) {
+                y++;
+            }
+            if (this->plane_count == 1) {
+                this->screen->copy_rows(this->vram[0], first, y - first);
+            } else {
+                this->screen->copy_planes(
+                    this->vram, this->plane_count, first, y - first);
+            }
+        } else {
+            y++;
+        }
+    }
+    this->dirty_rows = 0;
     this->screen->refresh_screen();
     return;
 }
 
+/**
+ * FNV-1a works a byte at a time. Each word's bytes are taken from the top down,
+ *   which is the order their pixels appear on screen, so the hash doesn't
+ *   depend on which way round the host stores its words.
+ */
+uint64_t tehVIDEO::hash_framebuffer() {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int p = 0; p < this->plane_count; p++) {
+        for (int i = 0; i < this->fb_height * this->fb_words; i++) {
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                hash ^= (this->vram[p][i] >> shift) & 0xFF;
+                hash *= 0x100000001B3ULL;
+            }
+        }
+    }
+    return hash;
+}
+
 bool* tehVIDEO::get_framebuffer() {
+    this->unpack_rows(0, this->fb_height);
     return this->pixel_array;
 }
 
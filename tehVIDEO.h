@@ -9,7 +9,9 @@
 #ifndef TEH_VIDEO_H_
 #define TEH_VIDEO_H_
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include "tehCOMMONZ.h"
 #include "tehSCREEN.h"
@@ -18,10 +20,25 @@ class tehVIDEO {
 private:
     tehSCREEN *screen;
 
-    // This array of pixels acts as our vram.
+    // These arrays of packed rows act as our vram, one per plane. Each row is
+    //  one or two 64 bit words, with the leftmost pixel in the most significant
+    //  bit. Only XO-CHIP has a second plane; otherwise it's left null.
+    uint64_t *vram[chippy::MAX_PLANES];
+    // Number of planes in use.
+    int plane_count;
+    // One bit per plane, set for every plane that draws, clears, and scrolls.
+    int plane_mask;
+    // Number of 64 bit words in each row of vram.
+    int fb_words;
+    // One bool per pixel, unpacked from vram by get_framebuffer().
     bool *pixel_array;
+    // One bit per row, set for every row that has changed since the last
+    //  update_screen(). Row 0 is the least significant bit.
+    uint64_t dirty_rows;
     // Set to true to enable pixel doubling in SUPERCHIP quirks mode.
     bool pixel_doubling;
+    // Set to true to clip sprites at the screen edge, false to wrap them.
+    bool clipping;
     // Determines our quirks mode.
     chippy::systype system;
     // Framebuffer width.
@@ -42,54 +59,63 @@ private:
     void delete_pixel_array();
 
     /**
-     * @brief Internal utility function that draws one stride of a sprite.
+     * @brief Internal utility function that draws a sprite to one plane.
      * 
-     * This function is called by draw_sprite() to draw a single byte of data.
-     * 
-     * @param x The dsired X position.
-     * @param y The desired Y position.
-     * @param byte The data to draw.
-     * @return If True, we have collided with sprite data.
+     * @param plane The plane to draw to.
+     * @param x The desired X position of our sprite.
+     * @param y The desired Y position of our sprite.
+     * @param size The number of lines to draw our sprite across.
+     * @param memory The sprite data for this plane.
+     * @return The number of rows that collided, or were clipped.
      */
-    bool draw_byte(int x, int y, unsigned char byte);
+    int draw_plane(int plane, int x, int y, int size, 
+                   const unsigned char *memory);
 
     /**
-     * @brief Internal utility function that draws a point.
+     * @brief Internal utility function that draws one row of a sprite.
      * 
-     * This function is called by draw_byte to draw a single point in the
-     *  framebuffer. Here we determine whether pixel doubling is needed or not.
+     * This function is called by draw_plane() once for every row of the 
+     *  sprite, or twice when pixel doubling. It handles clipping, or wrapping,
+     *  at the bottom of the screen, and XORs the row into vram.
      * 
+     * @param plane The plane to draw to.
      * @param x The desired X position.
      * @param y The desired Y position.
+     * @param pattern The row to draw, starting from the most significant bit.
      * @return If True, we have collided with sprite data.
      */
-    bool draw_point(int x, int y);
+    bool draw_row(int plane, int x, int y, uint64_t pattern);
 
     /**
-     * @brief Internal utility function that draws a single point.
+     * @brief Internal utility function that XORs bits into one word of a row.
      * 
-     * This function is called by draw_point and draw_double_point. It handles
-     *  sprite clipping, and actually draws, and tests the pixel in the frame-
-     *  buffer.
+     * Words past the end of the row are clipped, or wrapped back around to the
+     *  start of the row.
      * 
-     * @param x The desired X position.
-     * @param y The desired Y position.
+     * @param row The row to draw into.
+     * @param word The index of the word within the row.
+     * @param bits The bits to XOR into the word.
      * @return If True, we have collided with sprite data.
      */
-    bool draw_single_point(int x, int y);
+    bool draw_word(uint64_t *row, int word, uint64_t bits);
 
     /**
-     * @brief Internal utility function that draws a size doubled point.
+     * @brief Internal utility function that doubles every bit in a sprite row.
+     * 
+     * Bit n of the input ends up in bits 2n, and 2n + 1, of the output.
      * 
-     * This function is called by draw_point in SUPERCHIP quirks mode, when
-     *  sprite doubling is enabled. Internally, it calls draw_single_point() 4
-     *  times to draw larger pixels.
+     * @param bits Up to 16 bits of sprite data.
+     * @return Twice as many bits of sprite data.
+     */
+    uint64_t spread_bits(uint64_t bits);
+
+    /**
+     * @brief Internal utility function that unpacks rows of vram.
      * 
-     * @param x The desired x position.
-     * @param y The desired y position.
-     * @return If True, we have collided with srpite data.
+     * @param first The first row to unpack into pixel_array.
+     * @param count The number of rows to unpack.
      */
-    bool draw_double_point(int x, int y);
+    void unpack_rows(int first, int count);
 
     /**
      * @brief Internal utility function that handles wrapping logic for sprites.
@@ -114,10 +140,29 @@ public:
     ~tehVIDEO();
 
     /**
-     * @brief Sets every value in the framebuffer to black.
+     * @brief Sets every value in the selected planes to black.
      */
     void blank_screen();
 
+    /**
+     * @brief Selects the planes that are drawn to, cleared, and scrolled.
+     * 
+     * Only XO-CHIP has more than one plane. Bits for planes that don't exist
+     *  are ignored.
+     * 
+     * @param mask One bit per plane, starting with the first in bit 0.
+     */
+    void select_planes(int mask);
+
+    /**
+     * @brief Returns how many planes are currently selected.
+     * 
+     * A sprite needs one sprite's worth of data for each of them.
+     * 
+     * @return The number of selected planes.
+     */
+    int get_selected_planes();
+
     /**
      * @brief Toggles pixel doubling mode in SUPERCHIP quirks mode.
      * 
@@ -134,38 +179,87 @@ public:
      */
     bool get_video_mode();
 
+    /**
+     * @brief Toggles sprite clipping at the edges of the screen.
+     * 
+     * @param mode If True, sprites are clipped, otherwise they wrap around.
+     */
+    void set_clipping(bool mode);
+
+    /**
+     * @brief Scrolls the framebuffer down, blanking the rows scrolled in.
+     * 
+     * This moves whole rows of vram, and never touches individual pixels.
+     * 
+     * @param n The number of framebuffer pixels to scroll by.
+     */
+    void scroll_down(int n);
+
+    /**
+     * @brief Scrolls the framebuffer right, blanking the pixels scrolled in.
+     * 
+     * This shifts every row a word at a time, carrying bits across words.
+     * 
+     * @param n The number of framebuffer pixels to scroll by, less than 64.
+     */
+    void scroll_right(int n);
+
+    /**
+     * @brief Scrolls the framebuffer left, blanking the pixels scrolled in.
+     * 
+     * @param n The number of framebuffer pixels to scroll by, less than 64.
+     */
+    void scroll_left(int n);
+
     /**
      * @brief Copies the framebuffer to our tehSCREEN interface for display.
+     * 
+     * Only rows that have changed since the last update are copied, and they
+     *  are copied packed, exactly as they are stored in vram.
      */
     void update_screen();
 
     /**
      * @brief Draws a sprite to the framebuffer.
      * 
-     * NOTE: We can probably copy by reference, here.
-     * 
      * This function will draw a sprite to the framebuffer, respecting clipping,
      *  and the current quirks mode.
      * 
      * If we are in SUPERCHIP hi-res mode, then a sprite with a length of 16
      *  will draw a 16x16 sprite.
      * 
-     * This function will return false if we 'collide' with existing sprite
-     *  data - Flipping a pixel from white, to black.
+     * This function will return the number of sprite rows that 'collide' with
+     *  existing sprite data - Flipping a pixel from white, to black. In 
+     *  SUPERCHIP 1.1 hi-res mode, rows clipped by the bottom of the screen are
+     *  counted, too. Any nonzero count means that we have collided.
      * 
      * @param x The desired X position of our sprite.
      * @param y The desired Y position of our sprite.
      * @param size The number of lines to draw our sprite across.
-     * @param memory An array containing sprite data to copy from.
-     * @return If True, we have collided with sprite data.
+     * @param memory The sprite data to draw, for every selected plane, one 
+     *  after the other.
+     * @return The number of rows that collided, or were clipped.
+     */
+    int draw_sprite(int x, int y, int size, const unsigned char *memory);
+
+    /**
+     * @brief Returns a hash of everything in the framebuffer.
+     * 
+     * Every plane is hashed, packed, exactly as it's stored in vram, so two 
+     *  framebuffers hash the same only if every pixel of every plane matches.
+     *  Bytes are hashed in screen order, so hashes match between hosts.
+     * 
+     * @returns A 64 bit FNV-1a hash of vram.
      */
-    bool draw_sprite( int x, int y, int size, unsigned char (&memory)[32]);
+    uint64_t hash_framebuffer();
 
     // The framebuffer getters don't seem to be in use, anywhere.
 
     /**
      * @brief Returns a pointer to the framebuffer array.
      * 
+     * VRAM is packed, so this unpacks it into one bool per pixel first. A 
+     *  pixel is true if it's lit in any plane.
      * 
      * @returns A pointer to a boolean array holding the framebuffer data.
      */